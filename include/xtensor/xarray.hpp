@@ -42,6 +42,11 @@ namespace xt
     {
     };
 
+    template <class EC, layout L, class SC>
+    struct is_concurrently_readable<xarray_container<EC, L, SC>> : std::true_type
+    {
+    };
+
     /**
      * @class xarray_container
      * @brief Dense multidimensional container with tensor semantic.
@@ -138,6 +143,11 @@ namespace xt
     {
     };
 
+    template <class EC, layout L, class SC>
+    struct is_concurrently_readable<xarray_adaptor<EC, L, SC>> : std::true_type
+    {
+    };
+
     /**
      * @class xarray_adaptor
      * @brief Dense multidimensional container adaptor with
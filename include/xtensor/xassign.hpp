@@ -9,15 +9,22 @@
 #ifndef XASSIGN_HPP
 #define XASSIGN_HPP
 
+#include "xexecution.hpp"
 #include "xiterator.hpp"
 #include "xtensor_forward.hpp"
 #include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <utility>
 
 namespace xt
 {
     template <class E>
     class xexpression;
 
+    template <class D>
+    class xcontainer;
+
     /********************
      * Assign functions *
      ********************/
@@ -40,6 +47,47 @@ namespace xt
     template <class E1, class E2>
     void assert_compatible_shape(const xexpression<E1>& e1, const xexpression<E2>& e2);
 
+    /*****************
+     * has_assign_to *
+     *****************/
+
+    // Expressions that can evaluate themselves more efficiently than the
+    // stepper-based loop provide a member assign_to(e1) returning false
+    // when they leave the assignment to the default loop.
+    template <class E1, class E2>
+    struct has_assign_to
+    {
+        template <class E>
+        static auto test(int) -> decltype(std::declval<const E&>().assign_to(std::declval<E1&>()), std::true_type());
+
+        template <class E>
+        static std::false_type test(...);
+
+        static constexpr bool value = decltype(test<E2>(0))::value;
+    };
+
+    /********************
+     * has_strided_data *
+     ********************/
+
+    // Containers and views on containers whose storage is a contiguous
+    // buffer expose it together with the offset and strides addressing
+    // their elements.
+    template <class E>
+    struct has_strided_data
+    {
+        template <class T>
+        static auto test(int) -> decltype(std::declval<const T&>().data().data(),
+                                          std::declval<const T&>().raw_data_offset(),
+                                          std::declval<const T&>().strides(),
+                                          std::true_type());
+
+        template <class T>
+        static std::false_type test(...);
+
+        static constexpr bool value = decltype(test<E>(0))::value;
+    };
+
     /*****************
      * data_assigner *
      *****************/
@@ -59,6 +107,7 @@ namespace xt
         data_assigner(E1& e1, const E2& e2);
 
         void run();
+        void run(size_type first, size_type last);
 
         void step(size_type i);
         void reset(size_type i);
@@ -93,6 +142,295 @@ namespace xt
         {
             return false;
         }
+
+        // Splits the assignment along the first dimension; every task
+        // owns its steppers, so only trivial broadcasts of expressions
+        // that can be read concurrently are split.
+        template <class E1, class E2>
+        inline bool parallel_assign_data(E1& e1, const E2& e2)
+        {
+            using size_type = typename E1::size_type;
+            const auto& shape = e1.shape();
+            if (!is_concurrently_readable<E2>::value || shape.size() == 0 || shape[0] < 2 || !use_parallel(e1.size()))
+            {
+                return false;
+            }
+            size_type row_size = e1.size() / shape[0];
+            size_type grain = std::max(size_type(1), execution_options::execution_options().grain_size / std::max(row_size, size_type(1)));
+            parallel_for(0, shape[0], grain, [&e1, &e2](std::size_t first, std::size_t last) {
+                data_assigner<E1, E2> assigner(e1, e2);
+                assigner.run(first, last);
+            });
+            return true;
+        }
+
+        template <class E1, class E2>
+        inline bool assign_to(E1& e1, const E2& e2, std::true_type)
+        {
+            return e2.assign_to(e1);
+        }
+
+        template <class E1, class E2>
+        inline bool assign_to(E1&, const E2&, std::false_type)
+        {
+            return false;
+        }
+
+        // Writes the structural zeros of a 2-D expression in bulk and only
+        // evaluates it in the range of columns that may hold nonzeros; rows
+        // are split among threads if the expression can be read concurrently
+        template <class E1, class E2>
+        inline auto structured_assign(E1& e1, const E2& e2)
+            -> std::enable_if_t<std::is_base_of<xcontainer<E1>, E1>::value && has_nonzero_columns<E2>::value, bool>
+        {
+            using value_type = typename E1::value_type;
+            using size_type = typename E1::size_type;
+            const auto& shape = e1.shape();
+            if (e1.dimension() != 2 || e2.dimension() != 2 || e1.layout() != layout::row_major ||
+                !std::equal(shape.cbegin(), shape.cend(), e2.shape().cbegin()))
+            {
+                return false;
+            }
+            size_type nb_rows = shape[0];
+            size_type nb_cols = shape[1];
+            value_type* data = e1.raw_data() + e1.raw_data_offset();
+            auto assign_rows = [&e2, data, nb_cols](std::size_t first, std::size_t last) {
+                for (std::size_t i = first; i < last; ++i)
+                {
+                    auto range = e2.nonzero_columns(i);
+                    value_type* row = data + i * nb_cols;
+                    std::fill(row, row + range.first, value_type(0));
+                    for (std::size_t j = range.first; j < range.second; ++j)
+                    {
+                        row[j] = static_cast<value_type>(e2(i, j));
+                    }
+                    std::fill(row + range.second, row + nb_cols, value_type(0));
+                }
+            };
+            if (is_concurrently_readable<E2>::value && use_parallel(e1.size()))
+            {
+                size_type grain = std::max(size_type(1), execution_options::execution_options().grain_size / std::max(nb_cols, size_type(1)));
+                parallel_for(0, nb_rows, grain, assign_rows);
+            }
+            else
+            {
+                assign_rows(0, nb_rows);
+            }
+            return true;
+        }
+
+        template <class E1, class E2>
+        inline auto structured_assign(E1&, const E2&)
+            -> std::enable_if_t<!(std::is_base_of<xcontainer<E1>, E1>::value && has_nonzero_columns<E2>::value), bool>
+        {
+            return false;
+        }
+
+        template <class E>
+        struct is_strided_view
+            : std::integral_constant<bool, has_strided_data<E>::value && !std::is_base_of<xcontainer<E>, E>::value>
+        {
+        };
+
+        // Side of the square tiles copied by strided_assign when the
+        // source and the destination are contiguous along different
+        // dimensions, so that both are accessed by whole cache lines
+        constexpr std::size_t strided_tile_size = 32;
+
+        // Returns the dimension along which the expression that is not
+        // contiguous in the last dimension has its smallest stride, when
+        // the other one is contiguous in the last dimension, and the last
+        // dimension otherwise
+        template <class S, class ST1, class ST2>
+        inline std::size_t strided_tile_dimension(const S& shape, const ST1& dst_strides, const ST2& src_strides) noexcept
+        {
+            auto abs_stride = [](auto s) {
+                auto res = static_cast<std::ptrdiff_t>(s);
+                return res < 0 ? -res : res;
+            };
+            std::size_t last = shape.size() - 1;
+            bool dst_contiguous = abs_stride(dst_strides[last]) == 1;
+            bool src_contiguous = abs_stride(src_strides[last]) == 1;
+            if (shape[last] < 2 || dst_contiguous == src_contiguous)
+            {
+                return last;
+            }
+            std::size_t res = last;
+            std::ptrdiff_t min_stride = dst_contiguous ? abs_stride(src_strides[last]) : abs_stride(dst_strides[last]);
+            for (std::size_t d = 0; d < last; ++d)
+            {
+                std::ptrdiff_t stride = dst_contiguous ? abs_stride(src_strides[d]) : abs_stride(dst_strides[d]);
+                if (shape[d] > 1 && stride != 0 && stride < min_stride)
+                {
+                    min_stride = stride;
+                    res = d;
+                }
+            }
+            return res;
+        }
+
+        // Copies tiles spanning the dimension k and the last dimension,
+        // e.g. when materializing a transposed view
+        template <class P1, class P2, class S, class ST1, class ST2>
+        inline void strided_tiled_assign(P1 dst, P2 src, const S& shape, const ST1& dst_strides,
+                                         const ST2& src_strides, std::size_t k)
+        {
+            std::size_t last = shape.size() - 1;
+            std::size_t nb_rows = shape[k];
+            std::size_t nb_cols = shape[last];
+            std::size_t nb_row_tiles = (nb_rows + strided_tile_size - 1) / strided_tile_size;
+            std::size_t nb_tiles = compute_size(shape) / (nb_rows * nb_cols) * nb_row_tiles;
+            auto dst_row_stride = static_cast<std::ptrdiff_t>(dst_strides[k]);
+            auto src_row_stride = static_cast<std::ptrdiff_t>(src_strides[k]);
+            auto dst_col_stride = static_cast<std::ptrdiff_t>(dst_strides[last]);
+            auto src_col_stride = static_cast<std::ptrdiff_t>(src_strides[last]);
+            auto copy_tiles = [&, dst, src](std::size_t first, std::size_t end) {
+                for (std::size_t t = first; t < end; ++t)
+                {
+                    std::ptrdiff_t dst_offset = 0;
+                    std::ptrdiff_t src_offset = 0;
+                    std::size_t index = t / nb_row_tiles;
+                    for (std::size_t d = last; d != 0; --d)
+                    {
+                        if (d - 1 != k)
+                        {
+                            auto i = static_cast<std::ptrdiff_t>(index % shape[d - 1]);
+                            dst_offset += i * static_cast<std::ptrdiff_t>(dst_strides[d - 1]);
+                            src_offset += i * static_cast<std::ptrdiff_t>(src_strides[d - 1]);
+                            index /= shape[d - 1];
+                        }
+                    }
+                    std::size_t i0 = (t % nb_row_tiles) * strided_tile_size;
+                    std::size_t i1 = std::min(nb_rows, i0 + strided_tile_size);
+                    for (std::size_t j0 = 0; j0 < nb_cols; j0 += strided_tile_size)
+                    {
+                        std::size_t j1 = std::min(nb_cols, j0 + strided_tile_size);
+                        for (std::size_t i = i0; i < i1; ++i)
+                        {
+                            auto dst_row = dst + dst_offset + static_cast<std::ptrdiff_t>(i) * dst_row_stride;
+                            auto src_row = src + src_offset + static_cast<std::ptrdiff_t>(i) * src_row_stride;
+                            for (std::size_t j = j0; j < j1; ++j)
+                            {
+                                dst_row[static_cast<std::ptrdiff_t>(j) * dst_col_stride] = src_row[static_cast<std::ptrdiff_t>(j) * src_col_stride];
+                            }
+                        }
+                    }
+                }
+            };
+            if (use_parallel(compute_size(shape)))
+            {
+                std::size_t grain = std::max(std::size_t(1), execution_options::execution_options().grain_size / (strided_tile_size * nb_cols));
+                parallel_for(0, nb_tiles, grain, copy_tiles);
+            }
+            else
+            {
+                copy_tiles(0, nb_tiles);
+            }
+        }
+
+        // Copies between two expressions of the same shape addressing
+        // their elements through strides in a buffer, one row of the
+        // last dimension at a time, or by tiles when only one of them is
+        // contiguous in the last dimension
+        template <class E1, class E2>
+        inline auto strided_assign(E1& e1, const E2& e2)
+            -> std::enable_if_t<has_strided_data<E1>::value && has_strided_data<E2>::value, bool>
+        {
+            using size_type = typename E1::size_type;
+            const auto& shape = e1.shape();
+            size_type dim = e1.dimension();
+            if (dim == 0 || e2.dimension() != dim || !std::equal(shape.cbegin(), shape.cend(), e2.shape().cbegin()))
+            {
+                return false;
+            }
+            size_type inner_size = shape[dim - 1];
+            size_type nb_rows = inner_size == 0 ? size_type(0) : compute_size(shape) / inner_size;
+            auto dst_strides = e1.strides();
+            auto src_strides = e2.strides();
+            auto dst = e1.raw_data() + e1.raw_data_offset();
+            auto src = e2.raw_data() + e2.raw_data_offset();
+            if (nb_rows == 0)
+            {
+                return true;
+            }
+            std::size_t tile_dim = strided_tile_dimension(shape, dst_strides, src_strides);
+            if (tile_dim != dim - 1)
+            {
+                strided_tiled_assign(dst, src, shape, dst_strides, src_strides, tile_dim);
+                return true;
+            }
+            auto dst_inner = static_cast<std::ptrdiff_t>(dst_strides[dim - 1]);
+            auto src_inner = static_cast<std::ptrdiff_t>(src_strides[dim - 1]);
+            auto copy_rows = [&shape, &dst_strides, &src_strides, dim, inner_size, dst, src, dst_inner, src_inner](std::size_t first, std::size_t last) {
+                for (std::size_t r = first; r < last; ++r)
+                {
+                    std::ptrdiff_t dst_offset = 0;
+                    std::ptrdiff_t src_offset = 0;
+                    size_type index = r;
+                    for (size_type d = dim - 1; d != 0; --d)
+                    {
+                        auto i = static_cast<std::ptrdiff_t>(index % shape[d - 1]);
+                        dst_offset += i * static_cast<std::ptrdiff_t>(dst_strides[d - 1]);
+                        src_offset += i * static_cast<std::ptrdiff_t>(src_strides[d - 1]);
+                        index /= shape[d - 1];
+                    }
+                    auto dst_row = dst + dst_offset;
+                    auto src_row = src + src_offset;
+                    if (dst_inner == 1 && src_inner == 1)
+                    {
+                        std::copy(src_row, src_row + inner_size, dst_row);
+                    }
+                    else
+                    {
+                        for (size_type j = 0; j < inner_size; ++j)
+                        {
+                            dst_row[static_cast<std::ptrdiff_t>(j) * dst_inner] = src_row[static_cast<std::ptrdiff_t>(j) * src_inner];
+                        }
+                    }
+                }
+            };
+            if (use_parallel(e1.size()))
+            {
+                size_type grain = std::max(size_type(1), execution_options::execution_options().grain_size / std::max(inner_size, size_type(1)));
+                parallel_for(0, nb_rows, grain, copy_rows);
+            }
+            else
+            {
+                copy_rows(0, nb_rows);
+            }
+            return true;
+        }
+
+        template <class E1, class E2>
+        inline auto strided_assign(E1&, const E2&)
+            -> std::enable_if_t<!(has_strided_data<E1>::value && has_strided_data<E2>::value), bool>
+        {
+            return false;
+        }
+
+        template <class E1, class E2, class F>
+        inline void scalar_computed_assign_impl(E1& d, const E2& e2, F&& f, std::random_access_iterator_tag)
+        {
+            if (!use_parallel(d.size()))
+            {
+                std::transform(d.cbegin(), d.cend(), d.begin(),
+                               [e2, &f](const auto& v) { return f(v, e2); });
+                return;
+            }
+            parallel_for(0, d.size(), execution_options::execution_options().grain_size,
+                         [&d, &e2, &f](std::size_t first, std::size_t last) {
+                             auto it = d.begin() + static_cast<std::ptrdiff_t>(first);
+                             std::transform(it, it + static_cast<std::ptrdiff_t>(last - first), it,
+                                            [e2, &f](const auto& v) { return f(v, e2); });
+                         });
+        }
+
+        template <class E1, class E2, class F>
+        inline void scalar_computed_assign_impl(E1& d, const E2& e2, F&& f, std::forward_iterator_tag)
+        {
+            std::transform(d.cbegin(), d.cend(), d.begin(),
+                           [e2, &f](const auto& v) { return f(v, e2); });
+        }
     }
 
     template <class E1, class E2>
@@ -101,11 +439,16 @@ namespace xt
         E1& de1 = e1.derived_cast();
         const E2& de2 = e2.derived_cast();
         bool trivial_broadcast = trivial && detail::is_trivial_broadcast(de1, de2);
-        if (trivial_broadcast)
+        if (trivial_broadcast && !detail::is_strided_view<E2>::value)
         {
-            std::copy(de2.cbegin(), de2.cend(), de1.begin());
+            if (!detail::parallel_assign_data(de1, de2))
+            {
+                std::copy(de2.cbegin(), de2.cend(), de1.begin());
+            }
         }
-        else
+        else if (!detail::assign_to(de1, de2, std::integral_constant<bool, has_assign_to<E1, E2>::value>()) &&
+                 !detail::structured_assign(de1, de2) &&
+                 !detail::strided_assign(de1, de2))
         {
             data_assigner<E1, E2> assigner(de1, de2);
             assigner.run();
@@ -160,9 +503,8 @@ namespace xt
     template <class E1, class E2, class F>
     inline void scalar_computed_assign(xexpression<E1>& e1, const E2& e2, F&& f)
     {
-        E1& d = e1.derived_cast();
-        std::transform(d.cbegin(), d.cend(), d.begin(),
-                       [e2, &f](const auto& v) { return f(v, e2); });
+        using iterator_category = typename std::iterator_traits<typename E1::iterator>::iterator_category;
+        detail::scalar_computed_assign_impl(e1.derived_cast(), e2, std::forward<F>(f), iterator_category());
     }
 
     template <class E1, class E2>
@@ -203,6 +545,27 @@ namespace xt
         }
     }
 
+    /**
+     * Assigns the elements whose first index lies in [first, last).
+     */
+    template <class E1, class E2>
+    inline void data_assigner<E1, E2>::run(size_type first, size_type last)
+    {
+        if (first != 0)
+        {
+            m_lhs.step(0, first);
+            m_rhs.step(0, first);
+        }
+        shape_type block_shape = m_e1.shape();
+        block_shape[0] = last - first;
+        size_type count = compute_size(block_shape);
+        for (size_type k = 0; k < count; ++k)
+        {
+            *m_lhs = *m_rhs;
+            increment_stepper(*this, m_index, block_shape);
+        }
+    }
+
     template <class E1, class E2>
     inline void data_assigner<E1, E2>::step(size_type i)
     {
@@ -60,6 +60,12 @@ namespace xt
         using iterator = const_iterator;
     };
 
+    template <class CT, class X>
+    struct is_concurrently_readable<xbroadcast<CT, X>>
+        : is_concurrently_readable<std::decay_t<CT>>
+    {
+    };
+
     /**
      * @class xbroadcast
      * @brief Broadcasted xexpression to a specified shape.
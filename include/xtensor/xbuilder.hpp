@@ -13,13 +13,19 @@
 #ifndef XBUILDER_HPP
 #define XBUILDER_HPP
 
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <functional>
+#include <numeric>
 #include <utility>
+#include <vector>
 
 #include "xbroadcast.hpp"
+#include "xexecution.hpp"
 #include "xfunction.hpp"
 #include "xgenerator.hpp"
+#include "xstrided_view.hpp"
 
 #ifdef X_OLD_CLANG
     #include <initializer_list>
@@ -89,6 +95,33 @@ namespace xt
 
     namespace detail
     {
+        // Calls f on blocks covering [0, size), in parallel when the
+        // execution policy allows it
+        template <class F>
+        inline void fill_blocks(std::size_t size, F&& f)
+        {
+            if (use_parallel(size))
+            {
+                parallel_for(0, size, execution_options::execution_options().grain_size, std::forward<F>(f));
+            }
+            else
+            {
+                f(std::size_t(0), size);
+            }
+        }
+
+        // Range of the only column of a row that may hold a nonzero, on the
+        // diagonal of offset k
+        inline std::pair<std::size_t, std::size_t> diagonal_columns(std::size_t row, long int k, std::size_t nb_cols)
+        {
+            long int col = static_cast<long int>(row) + k;
+            if (col < 0 || col >= static_cast<long int>(nb_cols))
+            {
+                return {0, 0};
+            }
+            return {std::size_t(col), std::size_t(col) + 1};
+        }
+
         template <class T>
         class arange_impl
         {
@@ -96,6 +129,8 @@ namespace xt
 
             using value_type = T;
 
+            static constexpr bool is_cheap = true;
+
             arange_impl(T start, T stop, T step)
                 : m_start(start), m_stop(stop), m_step(step)
             {
@@ -113,6 +148,24 @@ namespace xt
                 return m_start + m_step * T(*first);
             }
 
+            template <class E, class S>
+            inline bool assign_to(E& e, const S& shape) const
+            {
+                auto* data = linear_storage(e, shape);
+                if (data == nullptr)
+                {
+                    return false;
+                }
+                using storage_type = std::decay_t<decltype(*data)>;
+                fill_blocks(compute_size(shape), [this, data](std::size_t first, std::size_t last) {
+                    for (std::size_t i = first; i < last; ++i)
+                    {
+                        data[i] = static_cast<storage_type>(m_start + m_step * T(i));
+                    }
+                });
+                return true;
+            }
+
         private:
 
             value_type m_start;
@@ -147,8 +200,8 @@ namespace xt
             template <class... Args>
             inline value_type operator()(Args... args) const
             {
-                size_type idx[sizeof...(Args)] = {static_cast<size_type>(args)...};
-                return access_impl(std::begin(idx), std::end(idx));
+                std::array<size_type, sizeof...(Args)> idx = {{static_cast<size_type>(args)...}};
+                return access_impl(idx.cbegin(), idx.cend());
             }
 
             template <class It>
@@ -157,6 +210,22 @@ namespace xt
                 return access_impl(first, last);
             }
 
+            template <class E, class S, class FT = F>
+            inline auto assign_to(E& e, const S& shape) const
+                -> decltype(std::declval<const FT&>().assign_to(e, shape))
+            {
+                return m_ft.assign_to(e, shape);
+            }
+
+            template <class S, class FT = F>
+            inline auto nonzero_columns(std::size_t row, const S& shape) const
+                -> decltype(std::declval<const FT&>().nonzero_columns(row, shape))
+            {
+                return m_ft.nonzero_columns(row, shape);
+            }
+
+            static constexpr bool is_cheap = is_cheap_functor<F>::value;
+
         private:
             F m_ft;
             template <class It>
@@ -184,9 +253,113 @@ namespace xt
                 return *(end - 1) == *(end - 2) + m_k ? T(1) : T(0);
             }
 
+            // Zeroes the storage, then only writes the diagonals
+            template <class E, class S>
+            inline bool assign_to(E& e, const S& shape) const
+            {
+                auto* data = linear_storage(e, shape);
+                if (data == nullptr)
+                {
+                    return false;
+                }
+                using storage_type = std::decay_t<decltype(*data)>;
+                std::size_t size = compute_size(shape);
+                std::fill(data, data + size, storage_type(0));
+                std::size_t nb_rows = shape[shape.size() - 2];
+                std::size_t nb_cols = shape[shape.size() - 1];
+                std::size_t matrix_size = nb_rows * nb_cols;
+                std::size_t first_row = m_k < 0 ? std::size_t(-m_k) : std::size_t(0);
+                std::size_t first_col = m_k > 0 ? std::size_t(m_k) : std::size_t(0);
+                for (std::size_t m = 0; m < size; m += matrix_size)
+                {
+                    for (std::size_t r = first_row, c = first_col; r < nb_rows && c < nb_cols; ++r, ++c)
+                    {
+                        data[m + r * nb_cols + c] = storage_type(1);
+                    }
+                }
+                return true;
+            }
+
+            template <class S>
+            inline std::pair<std::size_t, std::size_t> nonzero_columns(std::size_t row, const S& shape) const
+            {
+                return diagonal_columns(row, m_k, shape.back());
+            }
+
+            static constexpr bool is_cheap = true;
+
         private:
             int m_k;
         };
+
+        template <class T>
+        class logspace_impl
+        {
+        public:
+
+            using value_type = T;
+
+            static constexpr bool is_cheap = true;
+
+            logspace_impl(T start, T step, T base)
+                : m_start(start), m_step(step), m_base(base)
+            {
+            }
+
+            template <class... Args>
+            inline T operator()(Args... args) const
+            {
+                return access_impl(args...);
+            }
+
+            template <class It>
+            inline T element(It first, It) const
+            {
+                return power(m_start + m_step * T(*first));
+            }
+
+            template <class E, class S>
+            inline bool assign_to(E& e, const S& shape) const
+            {
+                auto* data = linear_storage(e, shape);
+                if (data == nullptr)
+                {
+                    return false;
+                }
+                using storage_type = std::decay_t<decltype(*data)>;
+                fill_blocks(compute_size(shape), [this, data](std::size_t first, std::size_t last) {
+                    for (std::size_t i = first; i < last; ++i)
+                    {
+                        data[i] = static_cast<storage_type>(power(m_start + m_step * T(i)));
+                    }
+                });
+                return true;
+            }
+
+        private:
+
+            value_type m_start;
+            value_type m_step;
+            value_type m_base;
+
+            // Same value type as pow applied to a linspace of T, which
+            // logspace used to return
+            inline T power(T exponent) const
+            {
+                return static_cast<T>(std::pow(m_base, exponent));
+            }
+
+            template <class T1, class... Args>
+            inline T access_impl(T1 t, Args...) const
+            {
+                return power(m_start + m_step * T(t));
+            }
+
+            inline T access_impl() const
+            {
+                return power(m_start);
+            }
+        };
     }
 
     /**
@@ -276,11 +449,91 @@ namespace xt
     template <class T>
     inline auto logspace(T start, T stop, std::size_t num_samples, T base = 10, bool endpoint = true) noexcept
     {
-        return pow(std::forward<T>(base), linspace(start, stop, num_samples, endpoint));
+        T step = (stop - start) / T(num_samples - (endpoint ? 1 : 0));
+        return detail::make_xgenerator(detail::logspace_impl<T>(start, step, base), {num_samples});
     }
 
     namespace detail
     {
+        // Returns the storage of e if e is a row-major container, nullptr otherwise
+        template <class E>
+        inline auto row_major_data(const E& e)
+            -> std::enable_if_t<std::is_base_of<xcontainer<E>, E>::value, const typename E::value_type*>
+        {
+            return e.layout() == xt::layout::row_major ? e.raw_data() : nullptr;
+        }
+
+        template <class E>
+        inline auto row_major_data(const E&)
+            -> std::enable_if_t<!std::is_base_of<xcontainer<E>, E>::value, const typename E::value_type*>
+        {
+            return nullptr;
+        }
+
+        // Copies the inputs of a concatenation into the row-major storage
+        // data. Input k holds extents[k] * inner contiguous elements for each
+        // of the outer hyperplanes; these runs are copied in bulk, in
+        // parallel when the execution policy allows it. Returns false if an
+        // input is not a row-major container.
+        template <class T, class... CT>
+        inline bool concatenate_copy(T* data, const std::tuple<CT...>& t, const std::vector<std::size_t>& extents,
+                                     std::size_t outer, std::size_t inner)
+        {
+            auto is_contiguous = [](bool prev, const auto& arr) {
+                return prev && row_major_data(arr) != nullptr;
+            };
+            if (!accumulate(is_contiguous, true, t))
+            {
+                return false;
+            }
+            std::size_t nb_inputs = sizeof...(CT);
+            std::vector<std::size_t> offsets(nb_inputs, 0);
+            for (std::size_t k = 1; k < nb_inputs; ++k)
+            {
+                offsets[k] = offsets[k - 1] + extents[k - 1];
+            }
+            std::size_t row_size = (offsets.back() + extents.back()) * inner;
+            auto copy_units = [&](std::size_t first, std::size_t last) {
+                for (std::size_t u = first; u < last; ++u)
+                {
+                    std::size_t o = u / nb_inputs;
+                    std::size_t k = u % nb_inputs;
+                    std::size_t length = extents[k] * inner;
+                    T* dst = data + o * row_size + offsets[k] * inner;
+                    apply<bool>(k, [o, length, dst](const auto& arr) {
+                        auto src = row_major_data(arr) + o * length;
+                        std::copy(src, src + length, dst);
+                        return true;
+                    }, t);
+                }
+            };
+            std::size_t nb_units = outer * nb_inputs;
+            std::size_t size = outer * row_size;
+            if (use_parallel(size))
+            {
+                std::size_t unit_size = std::max(size / std::max(nb_units, std::size_t(1)), std::size_t(1));
+                std::size_t grain = std::max(execution_options::execution_options().grain_size / unit_size, std::size_t(1));
+                parallel_for(0, nb_units, grain, copy_units);
+            }
+            else
+            {
+                copy_units(0, nb_units);
+            }
+            return true;
+        }
+
+        template <class S>
+        inline std::size_t outer_size(const S& shape, std::size_t axis)
+        {
+            return std::accumulate(shape.begin(), shape.begin() + std::ptrdiff_t(axis), std::size_t(1), std::multiplies<std::size_t>());
+        }
+
+        template <class S>
+        inline std::size_t inner_size(const S& shape, std::size_t axis)
+        {
+            return std::accumulate(shape.begin() + std::ptrdiff_t(axis) + 1, shape.end(), std::size_t(1), std::multiplies<std::size_t>());
+        }
+
         template <class... CT>
         class concatenate_impl
         {
@@ -297,34 +550,53 @@ namespace xt
             template <class... Args>
             inline value_type operator()(Args... args) const
             {
-                // TODO: avoid memory allocation
-                return access_impl(xindex({{static_cast<size_type>(args)...}}));
+                std::array<size_type, sizeof...(Args)> idx = {{static_cast<size_type>(args)...}};
+                return access_impl(idx.begin(), idx.end());
             }
 
             template <class It>
             inline value_type element(It first, It last) const
             {
-                // TODO: avoid memory allocation
-                return access_impl(xindex(first, last));
+                index_buffer idx(first, last);
+                return access_impl(idx.begin(), idx.end());
+            }
+
+            template <class E, class S>
+            inline bool assign_to(E& e, const S& shape) const
+            {
+                auto* data = linear_storage(e, shape);
+                if (data == nullptr)
+                {
+                    return false;
+                }
+                std::vector<std::size_t> extents;
+                auto get_extent = [this, &extents](bool prev, const auto& arr) {
+                    extents.push_back(arr.shape()[this->m_axis]);
+                    return prev;
+                };
+                accumulate(get_extent, true, m_t);
+                return concatenate_copy(data, m_t, extents, outer_size(shape, m_axis), inner_size(shape, m_axis));
             }
 
         private:
 
-            inline value_type access_impl(xindex idx) const
+            template <class It>
+            inline value_type access_impl(It first, It last) const
             {
-                auto match = [this, &idx](auto& arr)
+                auto& axis_index = *(first + std::ptrdiff_t(m_axis));
+                auto match = [this, &axis_index](auto& arr)
                 {
-                    if (idx[this->m_axis] >= arr.shape()[this->m_axis])
+                    if (axis_index >= arr.shape()[this->m_axis])
                     {
-                        idx[this->m_axis] -= arr.shape()[this->m_axis];
+                        axis_index -= arr.shape()[this->m_axis];
                         return false;
                     }
                     return true;
                 };
 
-                auto get = [&idx](auto& arr)
+                auto get = [first, last](auto& arr)
                 {
-                    return arr[idx];
+                    return arr.element(first, last);
                 };
 
                 std::size_t i = 0;
@@ -358,27 +630,43 @@ namespace xt
             template <class... Args>
             inline value_type operator()(Args... args) const
             {
-                // TODO: avoid memory allocation
-                return access_impl(xindex({{static_cast<size_type>(args)...}}));
+                std::array<size_type, sizeof...(Args)> idx = {{static_cast<size_type>(args)...}};
+                return access_impl(idx.begin(), idx.end());
             }
 
             template <class It>
             inline value_type element(It first, It last) const
             {
-                // TODO: avoid memory allocation
-                return access_impl(xindex(first, last));
+                return access_impl(first, last);
+            }
+
+            // Stacking is a concatenation of inputs of extent 1 along axis
+            template <class E, class S>
+            inline bool assign_to(E& e, const S& shape) const
+            {
+                auto* data = linear_storage(e, shape);
+                if (data == nullptr)
+                {
+                    return false;
+                }
+                std::vector<std::size_t> extents(sizeof...(CT), 1);
+                return concatenate_copy(data, m_t, extents, outer_size(shape, m_axis), inner_size(shape, m_axis));
             }
 
         private:
 
-            inline value_type access_impl(xindex idx) const
+            // The input is selected by the index along axis, which is
+            // dropped from the index passed to the input
+            template <class It>
+            inline value_type access_impl(It first, It last) const
             {
+                index_buffer idx(first, last);
+                std::size_t i = idx[m_axis];
+                idx.erase(idx.begin() + std::ptrdiff_t(m_axis));
                 auto get_item = [&idx](auto& arr)
                 {
-                    return arr[idx];
+                    return arr.element(idx.cbegin(), idx.cend());
                 };
-                std::size_t i = idx[m_axis];
-                idx.erase(idx.begin() + m_axis);
                 return apply<value_type>(i, get_item, m_t);
             }
 
@@ -563,7 +851,7 @@ namespace xt
             template <class It>
             inline value_type operator()(It begin, It) const
             {
-                xindex idx(m_source.shape().size());
+                index_buffer idx(m_source.shape().size());
 
                 for (std::size_t i = 0; i < idx.size(); i++)
                 {
@@ -582,7 +870,7 @@ namespace xt
                     idx[m_axis_1] = *(begin) - m_offset;
                     idx[m_axis_2] = *(begin);
                 }
-                return m_source[idx];
+                return m_source.element(idx.cbegin(), idx.cend());
             }
 
         private:
@@ -620,6 +908,12 @@ namespace xt
                 }
             }
 
+            template <class S>
+            inline std::pair<std::size_t, std::size_t> nonzero_columns(std::size_t row, const S& shape) const
+            {
+                return diagonal_columns(row, m_k, shape[1]);
+            }
+
         private:
 
             CT m_source;
@@ -651,8 +945,7 @@ namespace xt
             template <class It>
             inline value_type element(It first, It last) const
             {
-                // TODO: avoid memory allocation
-                xindex idx(first, last);
+                index_buffer idx(first, last);
                 return access_impl(idx.begin(), idx.end());
             }
 
@@ -671,6 +964,28 @@ namespace xt
             const size_type m_shape_at_axis;
         };
 
+        // Containers are flipped by a strided view that walks the axis
+        // backward from its last element
+        template <class E>
+        inline auto make_flip(E&& arr, std::size_t axis, std::true_type)
+        {
+            using view_type = xstrided_view<closure_t<E>>;
+            using strides_type = typename view_type::strides_type;
+            strides_type strides = forward_sequence<strides_type>(arr.strides());
+            std::size_t offset = arr.shape()[axis] == 0 ? 0 : std::size_t(strides[axis]) * (arr.shape()[axis] - 1);
+            strides[axis] = -strides[axis];
+            auto shape = arr.shape();
+            return view_type(std::forward<E>(arr), std::move(shape), std::move(strides), offset);
+        }
+
+        template <class E>
+        inline auto make_flip(E&& arr, std::size_t axis, std::false_type)
+        {
+            using CT = xclosure_t<E>;
+            auto shape = arr.shape();
+            return make_xgenerator(flip_impl<CT>(std::forward<E>(arr), axis), shape);
+        }
+
         template <class CT, class Comp>
         class trilu_fn
         {
@@ -693,14 +1008,46 @@ namespace xt
                 return m_comp(signed_idx_type(*begin) + m_k, signed_idx_type(*(begin + 1))) ? m_source.element(begin, end) : value_type(0);
             }
 
+            template <class S>
+            inline std::pair<std::size_t, std::size_t> nonzero_columns(std::size_t row, const S& shape) const
+            {
+                signed_idx_type nb_cols = signed_idx_type(shape[1]);
+                signed_idx_type bound = signed_idx_type(row) + m_k;
+                return columns(bound, nb_cols, m_comp);
+            }
+
         private:
 
+            // tril keeps the columns up to row + k, triu the columns from row + k
+            static std::pair<std::size_t, std::size_t> columns(signed_idx_type bound, signed_idx_type nb_cols, std::greater_equal<signed_idx_type>)
+            {
+                return {0, std::size_t(std::min(std::max(bound + 1, signed_idx_type(0)), nb_cols))};
+            }
+
+            static std::pair<std::size_t, std::size_t> columns(signed_idx_type bound, signed_idx_type nb_cols, std::less_equal<signed_idx_type>)
+            {
+                return {std::size_t(std::min(std::max(bound, signed_idx_type(0)), nb_cols)), std::size_t(nb_cols)};
+            }
+
             CT m_source;
             const signed_idx_type m_k;
             const Comp m_comp;
         };
     }
 
+    // Masks only read the expression they wrap
+    template <class CT, class R, class S>
+    struct is_concurrently_readable<xgenerator<detail::fn_impl<detail::diag_fn<CT>>, R, S>>
+        : is_concurrently_readable<std::decay_t<CT>>
+    {
+    };
+
+    template <class CT, class Comp, class R, class S>
+    struct is_concurrently_readable<xgenerator<detail::fn_impl<detail::trilu_fn<CT, Comp>>, R, S>>
+        : is_concurrently_readable<std::decay_t<CT>>
+    {
+    };
+
     /**
      * @brief Returns the elements on the diagonal of arr
      * If arr has more than two dimensions, then the axes specified by 
@@ -788,6 +1135,10 @@ namespace xt
      * Note: A NumPy/Matlab style `flipud(arr)` is equivalent to `xt::flip(arr, 0)`,
      * `fliplr(arr)` to `xt::flip(arr, 1)`.
      * 
+     * When \c arr is a container, the result is an \ref xstrided_view with a
+     * negative stride along \c axis, that can be assigned to; otherwise it is
+     * a generator.
+     *
      * @param arr the input xexpression
      * @param axis the axis along which elements should be reversed
      *
@@ -796,10 +1147,9 @@ namespace xt
     template <class E>
     inline auto flip(E&& arr, std::size_t axis)
     {
-        using CT = xclosure_t<E>;
-        auto shape = arr.shape();
-        return detail::make_xgenerator(detail::flip_impl<CT>(std::forward<E>(arr), axis),
-                                       shape);
+        using is_container = std::integral_constant<bool, std::is_base_of<xcontainer<std::decay_t<E>>, std::decay_t<E>>::value &&
+                                                          has_strided_data<std::decay_t<E>>::value>;
+        return detail::make_flip(std::forward<E>(arr), axis, is_container());
     }
 
     /**
@@ -810,6 +1160,12 @@ namespace xt
      * @param k the diagonal above which to zero elements. 0 (default) selects the main diagonal,
      *          k < 0 is below the main diagonal, k > 0 above.
      * @returns xexpression containing lower triangle from arr, 0 otherwise
+     *
+     * When a product of this expression with other expressions is assigned to a
+     * row-major 2-D container, the elements above the diagonal are written as zero
+     * without evaluating the other operands. NaN or infinite elements of these
+     * operands in that region then yield zero, while element access and the other
+     * assignments yield NaN.
      */
     template <class E>
     inline auto tril(E&& arr, int k = 0)
@@ -829,6 +1185,12 @@ namespace xt
      * @param k the diagonal below which to zero elements. 0 (default) selects the main diagonal,
      *          k < 0 is below the main diagonal, k > 0 above.
      * @returns xexpression containing lower triangle from arr, 0 otherwise
+     *
+     * When a product of this expression with other expressions is assigned to a
+     * row-major 2-D container, the elements below the diagonal are written as zero
+     * without evaluating the other operands. NaN or infinite elements of these
+     * operands in that region then yield zero, while element access and the other
+     * assignments yield NaN.
      */
     template <class E>
     inline auto triu(E&& arr, int k = 0)
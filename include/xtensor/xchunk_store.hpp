@@ -0,0 +1,1048 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XCHUNK_STORE_HPP
+#define XCHUNK_STORE_HPP
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <list>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+
+#include "xexception.hpp"
+#include "xexpression.hpp"
+#include "xiterable.hpp"
+#include "xserialize.hpp"
+#include "xstrides.hpp"
+#include "xutils.hpp"
+
+namespace xt
+{
+
+    /************************
+     * xchunk_store_options *
+     ************************/
+
+    /**
+     * @class xchunk_store_options
+     * @brief Codec and cache settings of a chunked store.
+     *
+     * The codecs are applied to each chunk in the order shuffle, delta,
+     * compression when writing, and in the reverse order when reading.
+     * A chunk whose compressed form is not smaller than its raw form is
+     * stored uncompressed.
+     */
+    struct xchunk_store_options
+    {
+        /// Groups the bytes of equal significance of the elements together.
+        bool shuffle = true;
+        /// Replaces each byte with its difference to the previous one.
+        bool delta = false;
+        /// Compresses the chunk with the built-in LZ codec.
+        bool compress = true;
+        /// Maximum number of decoded chunks kept in memory.
+        std::size_t cache_size = 16;
+    };
+
+    /******************
+     * xchunked_store *
+     ******************/
+
+    template <class T>
+    class xchunked_store;
+
+    template <class T>
+    struct xiterable_inner_types<xchunked_store<T>>
+    {
+        using inner_shape_type = std::vector<std::size_t>;
+        using const_stepper = xindexed_stepper<xchunked_store<T>>;
+        using stepper = const_stepper;
+        using const_broadcast_iterator = xiterator<const_stepper, inner_shape_type*>;
+        using broadcast_iterator = const_broadcast_iterator;
+        using const_iterator = const_broadcast_iterator;
+        using iterator = const_iterator;
+    };
+
+    /**
+     * @class xchunked_store
+     * @brief Chunked, compressed tensor stored on the local filesystem.
+     *
+     * The xchunked_store class provides an expression interface over a
+     * directory holding a small text metadata file and one file per chunk,
+     * named after the chunk coordinates joined by dots ("0.2.1"). Chunks
+     * are loaded and decoded lazily on access and kept in a LRU cache, so
+     * that random access to a sub-block only decodes the chunks it covers.
+     * Chunks that were never written read as zeros.
+     *
+     * Assigning an expression to the store evaluates and writes it chunk
+     * by chunk, so that the expression never needs to fit in memory.
+     *
+     * @tparam T the trivially copyable value type of the store
+     * @sa create_chunked_store, open_chunked_store
+     */
+    template <class T>
+    class xchunked_store : public xexpression<xchunked_store<T>>,
+                           public xexpression_const_iterable<xchunked_store<T>>
+    {
+
+    public:
+
+        static_assert(std::is_trivially_copyable<T>::value, "chunked store value type must be trivially copyable");
+
+        using self_type = xchunked_store<T>;
+
+        using value_type = T;
+        using reference = value_type;
+        using const_reference = value_type;
+        using pointer = value_type*;
+        using const_pointer = const value_type*;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        using iterable_base = xexpression_const_iterable<self_type>;
+        using inner_shape_type = typename iterable_base::inner_shape_type;
+        using shape_type = inner_shape_type;
+
+        using stepper = typename iterable_base::stepper;
+        using const_stepper = typename iterable_base::const_stepper;
+
+        using broadcast_iterator = typename iterable_base::broadcast_iterator;
+        using const_broadcast_iterator = typename iterable_base::const_broadcast_iterator;
+
+        using iterator = typename iterable_base::iterator;
+        using const_iterator = typename iterable_base::const_iterator;
+
+        static constexpr xt::layout layout_type = xt::layout::any;
+        static constexpr bool contiguous_layout = false;
+
+        explicit xchunked_store(const std::string& path);
+        xchunked_store(const std::string& path, const shape_type& shape,
+                       const shape_type& chunk_shape,
+                       const xchunk_store_options& options = xchunk_store_options());
+
+        ~xchunked_store() = default;
+
+        xchunked_store(const xchunked_store&);
+        xchunked_store& operator=(const xchunked_store&);
+
+        xchunked_store(xchunked_store&&) = default;
+        xchunked_store& operator=(xchunked_store&&) = default;
+
+        template <class E>
+        self_type& operator=(const xexpression<E>& e);
+
+        size_type size() const noexcept;
+        size_type dimension() const noexcept;
+        const inner_shape_type& shape() const noexcept;
+        const inner_shape_type& chunk_shape() const noexcept;
+        xt::layout layout() const noexcept;
+
+        const std::string& path() const noexcept;
+        const xchunk_store_options& options() const noexcept;
+
+        template <class... Args>
+        const_reference operator()(Args... args) const;
+        const_reference operator[](const xindex& index) const;
+
+        template <class It>
+        const_reference element(It first, It last) const;
+
+        template <class O>
+        bool broadcast_shape(O& shape) const;
+
+        template <class O>
+        bool is_trivial_broadcast(const O& /*strides*/) const noexcept;
+
+        template <class O>
+        const_stepper stepper_begin(const O& shape) const noexcept;
+        template <class O>
+        const_stepper stepper_end(const O& shape) const noexcept;
+
+    private:
+
+        using chunk_type = std::vector<value_type>;
+        using cache_list = std::list<std::pair<size_type, chunk_type>>;
+        using cache_map = std::unordered_map<size_type, typename cache_list::iterator>;
+
+        void init_grid();
+        void write_metadata() const;
+        void read_metadata();
+
+        std::string chunk_path(const shape_type& chunk_index) const;
+        shape_type chunk_coordinates(size_type id) const;
+
+        const chunk_type& get_chunk(size_type id) const;
+        chunk_type load_chunk(size_type id) const;
+        void store_chunk(size_type id, const chunk_type& chunk);
+        void insert_chunk(size_type id, chunk_type&& chunk) const;
+
+        std::string m_path;
+        shape_type m_shape;
+        shape_type m_chunk_shape;
+        shape_type m_grid_shape;
+        shape_type m_chunk_strides;
+        size_type m_chunk_size;
+        xchunk_store_options m_options;
+
+        mutable cache_list m_cache;
+        mutable cache_map m_cache_index;
+    };
+
+    template <class T>
+    xchunked_store<T> create_chunked_store(const std::string& path,
+                                           const std::vector<std::size_t>& shape,
+                                           const std::vector<std::size_t>& chunk_shape,
+                                           const xchunk_store_options& options = xchunk_store_options());
+
+    template <class T>
+    xchunked_store<T> open_chunked_store(const std::string& path);
+
+    /*************************
+     * codecs implementation *
+     *************************/
+
+    namespace detail
+    {
+        inline void byte_shuffle(const char* src, char* dst, std::size_t n, std::size_t elem_size) noexcept
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                for (std::size_t b = 0; b < elem_size; ++b)
+                {
+                    dst[b * n + i] = src[i * elem_size + b];
+                }
+            }
+        }
+
+        inline void byte_unshuffle(const char* src, char* dst, std::size_t n, std::size_t elem_size) noexcept
+        {
+            for (std::size_t b = 0; b < elem_size; ++b)
+            {
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    dst[i * elem_size + b] = src[b * n + i];
+                }
+            }
+        }
+
+        inline void delta_encode(char* buf, std::size_t n) noexcept
+        {
+            unsigned char prev = 0;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                unsigned char cur = static_cast<unsigned char>(buf[i]);
+                buf[i] = static_cast<char>(static_cast<unsigned char>(cur - prev));
+                prev = cur;
+            }
+        }
+
+        inline void delta_decode(char* buf, std::size_t n) noexcept
+        {
+            unsigned char prev = 0;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                prev = static_cast<unsigned char>(prev + static_cast<unsigned char>(buf[i]));
+                buf[i] = static_cast<char>(prev);
+            }
+        }
+
+        constexpr std::size_t lz_min_match = 4;
+        constexpr std::size_t lz_hash_bits = 14;
+        constexpr std::size_t lz_max_offset = 0xFFFF;
+
+        inline std::uint32_t lz_read32(const char* p) noexcept
+        {
+            std::uint32_t res;
+            std::memcpy(&res, p, sizeof(res));
+            return res;
+        }
+
+        inline void lz_write_length(std::string& out, std::size_t len)
+        {
+            while (len >= 255)
+            {
+                out.push_back(static_cast<char>(255));
+                len -= 255;
+            }
+            out.push_back(static_cast<char>(len));
+        }
+
+        inline void lz_write_sequence(std::string& out, const char* literals, std::size_t lit_len,
+                                      std::size_t offset, std::size_t match_len)
+        {
+            std::size_t ml = match_len == 0 ? 0 : match_len - lz_min_match;
+            std::size_t token = (std::min(lit_len, std::size_t(15)) << 4) | std::min(ml, std::size_t(15));
+            out.push_back(static_cast<char>(token));
+            if (lit_len >= 15)
+            {
+                lz_write_length(out, lit_len - 15);
+            }
+            out.append(literals, lit_len);
+            if (match_len != 0)
+            {
+                out.push_back(static_cast<char>(offset & 0xFF));
+                out.push_back(static_cast<char>((offset >> 8) & 0xFF));
+                if (ml >= 15)
+                {
+                    lz_write_length(out, ml - 15);
+                }
+            }
+        }
+
+        /**
+         * Compresses the n bytes starting at src with a LZ77 scheme in the
+         * spirit of LZ4: each sequence is a token holding the literal and
+         * match lengths, the literals, and a two-byte backward offset. The
+         * last sequence only holds literals.
+         */
+        inline std::string lz_compress(const char* src, std::size_t n)
+        {
+            std::string out;
+            out.reserve(n / 2 + 16);
+            std::vector<std::size_t> table(std::size_t(1) << lz_hash_bits, std::size_t(-1));
+            std::size_t anchor = 0;
+            std::size_t i = 0;
+            while (i + lz_min_match <= n)
+            {
+                std::uint32_t seq = lz_read32(src + i);
+                std::size_t h = static_cast<std::size_t>((seq * 2654435761u) >> (32 - lz_hash_bits));
+                std::size_t candidate = table[h];
+                table[h] = i;
+                if (candidate != std::size_t(-1) && i - candidate <= lz_max_offset && lz_read32(src + candidate) == seq)
+                {
+                    std::size_t len = lz_min_match;
+                    while (i + len < n && src[candidate + len] == src[i + len])
+                    {
+                        ++len;
+                    }
+                    lz_write_sequence(out, src + anchor, i - anchor, i - candidate, len);
+                    i += len;
+                    anchor = i;
+                }
+                else
+                {
+                    ++i;
+                }
+            }
+            lz_write_sequence(out, src + anchor, n - anchor, 0, 0);
+            return out;
+        }
+
+        inline std::size_t lz_read_length(const unsigned char*& ip, const unsigned char* end)
+        {
+            std::size_t len = 0;
+            unsigned char c;
+            do
+            {
+                if (ip == end)
+                {
+                    throw std::runtime_error("Corrupted compressed chunk");
+                }
+                c = *ip++;
+                len += c;
+            } while (c == 255);
+            return len;
+        }
+
+        /**
+         * Decompresses the n bytes starting at src, produced by lz_compress,
+         * into the dst_size bytes starting at dst.
+         */
+        inline void lz_decompress(const char* src, std::size_t n, char* dst, std::size_t dst_size)
+        {
+            const unsigned char* ip = reinterpret_cast<const unsigned char*>(src);
+            const unsigned char* end = ip + n;
+            std::size_t op = 0;
+            while (ip != end)
+            {
+                std::size_t token = *ip++;
+                std::size_t lit_len = token >> 4;
+                if (lit_len == 15)
+                {
+                    lit_len += lz_read_length(ip, end);
+                }
+                if (lit_len > static_cast<std::size_t>(end - ip) || lit_len > dst_size - op)
+                {
+                    throw std::runtime_error("Corrupted compressed chunk");
+                }
+                std::memcpy(dst + op, ip, lit_len);
+                ip += lit_len;
+                op += lit_len;
+                if (ip == end)
+                {
+                    break;
+                }
+                if (end - ip < 2)
+                {
+                    throw std::runtime_error("Corrupted compressed chunk");
+                }
+                std::size_t offset = std::size_t(ip[0]) | (std::size_t(ip[1]) << 8);
+                ip += 2;
+                std::size_t match_len = (token & 0xF);
+                if (match_len == 15)
+                {
+                    match_len += lz_read_length(ip, end);
+                }
+                match_len += lz_min_match;
+                if (offset == 0 || offset > op || match_len > dst_size - op)
+                {
+                    throw std::runtime_error("Corrupted compressed chunk");
+                }
+                // Byte per byte copy, source and destination may overlap
+                for (std::size_t k = 0; k < match_len; ++k, ++op)
+                {
+                    dst[op] = dst[op - offset];
+                }
+            }
+            if (op != dst_size)
+            {
+                throw std::runtime_error("Corrupted compressed chunk");
+            }
+        }
+
+        inline void make_directory(const std::string& path)
+        {
+#ifdef _WIN32
+            int res = _mkdir(path.c_str());
+#else
+            int res = mkdir(path.c_str(), 0755);
+#endif
+            if (res != 0 && errno != EEXIST)
+            {
+                throw std::runtime_error("Cannot create directory " + path);
+            }
+        }
+
+        template <class S>
+        inline void write_sequence_line(std::ostream& out, const char* name, const S& s)
+        {
+            out << name << ' ' << s.size();
+            for (auto v : s)
+            {
+                out << ' ' << v;
+            }
+            out << '\n';
+        }
+
+        template <class S>
+        inline void read_sequence_line(std::istream& in, const char* name, S& s)
+        {
+            std::string key;
+            std::size_t n = 0;
+            if (!(in >> key >> n) || key != name)
+            {
+                throw std::runtime_error(std::string("Invalid chunked store metadata, expected ") + name);
+            }
+            s.resize(n);
+            for (auto& v : s)
+            {
+                in >> v;
+            }
+        }
+
+        constexpr const char* chunk_store_metadata = ".xchunks";
+        constexpr int chunk_store_version = 1;
+    }
+
+    /*********************************
+     * xchunked_store implementation *
+     *********************************/
+
+    /**
+     * @name Constructors
+     */
+    //@{
+    /**
+     * Opens the existing chunked store located in the directory \c path.
+     * @param path the directory of the store
+     */
+    template <class T>
+    inline xchunked_store<T>::xchunked_store(const std::string& path)
+        : m_path(path), m_chunk_size(0)
+    {
+        read_metadata();
+        init_grid();
+    }
+
+    /**
+     * Creates a new chunked store in the directory \c path. The directory is
+     * created if needed; it must not already hold a chunked store, whose chunk
+     * files would be read as those of the new one.
+     * @param path the directory of the store
+     * @param shape the shape of the store
+     * @param chunk_shape the shape of a chunk
+     * @param options the codecs and cache settings
+     */
+    template <class T>
+    inline xchunked_store<T>::xchunked_store(const std::string& path, const shape_type& shape,
+                                             const shape_type& chunk_shape,
+                                             const xchunk_store_options& options)
+        : m_path(path), m_shape(shape), m_chunk_shape(chunk_shape), m_chunk_size(0), m_options(options)
+    {
+        if (m_chunk_shape.size() != m_shape.size())
+        {
+            throw std::runtime_error("Chunk shape and shape must have the same dimension");
+        }
+        if (std::find(m_chunk_shape.cbegin(), m_chunk_shape.cend(), size_type(0)) != m_chunk_shape.cend())
+        {
+            throw std::runtime_error("Chunk shape cannot have null extents");
+        }
+        if (std::ifstream(m_path + "/" + detail::chunk_store_metadata))
+        {
+            throw std::runtime_error("A chunked store already exists in " + m_path);
+        }
+        detail::make_directory(m_path);
+        write_metadata();
+        init_grid();
+    }
+
+    /**
+     * Builds another handle on the same store; the cache is not shared.
+     */
+    template <class T>
+    inline xchunked_store<T>::xchunked_store(const xchunked_store& rhs)
+        : m_path(rhs.m_path), m_shape(rhs.m_shape), m_chunk_shape(rhs.m_chunk_shape),
+          m_grid_shape(rhs.m_grid_shape), m_chunk_strides(rhs.m_chunk_strides),
+          m_chunk_size(rhs.m_chunk_size), m_options(rhs.m_options)
+    {
+    }
+
+    template <class T>
+    inline auto xchunked_store<T>::operator=(const xchunked_store& rhs) -> xchunked_store&
+    {
+        xchunked_store tmp(rhs);
+        *this = std::move(tmp);
+        return *this;
+    }
+    //@}
+
+    /**
+     * @name Assignment
+     */
+    //@{
+    /**
+     * Evaluates the expression \c e and writes it into the store, one chunk
+     * at a time. The expression must be broadcastable to the shape of the store.
+     * @param e the xexpression to assign
+     */
+    template <class T>
+    template <class E>
+    inline auto xchunked_store<T>::operator=(const xexpression<E>& e) -> self_type&
+    {
+        const E& de = e.derived_cast();
+        shape_type shape = m_shape;
+        if (de.dimension() > dimension())
+        {
+            throw broadcast_error(m_shape, de.shape());
+        }
+        de.broadcast_shape(shape);
+        if (shape != m_shape)
+        {
+            throw broadcast_error(m_shape, de.shape());
+        }
+
+        size_type nb_chunks = compute_size(m_grid_shape);
+        size_type dim = dimension();
+        shape_type index(dim, size_type(0));
+        shape_type extent(dim, size_type(0));
+        for (size_type id = 0; id < nb_chunks; ++id)
+        {
+            shape_type coords = chunk_coordinates(id);
+            auto st = de.stepper_begin(m_shape);
+            for (size_type d = 0; d < dim; ++d)
+            {
+                size_type origin = coords[d] * m_chunk_shape[d];
+                extent[d] = std::min(m_chunk_shape[d], m_shape[d] - origin);
+                index[d] = 0;
+                if (origin != 0)
+                {
+                    st.step(d, origin);
+                }
+            }
+
+            chunk_type chunk(m_chunk_size, value_type(0));
+            size_type offset = 0;
+            bool done = compute_size(extent) == 0;
+            while (!done)
+            {
+                chunk[offset] = static_cast<value_type>(*st);
+                size_type d = dim;
+                done = true;
+                while (d != 0)
+                {
+                    --d;
+                    if (index[d] + 1 < extent[d])
+                    {
+                        ++index[d];
+                        st.step(d);
+                        offset += m_chunk_strides[d];
+                        done = false;
+                        break;
+                    }
+                    if (index[d] != 0)
+                    {
+                        st.step_back(d, index[d]);
+                        offset -= index[d] * m_chunk_strides[d];
+                        index[d] = 0;
+                    }
+                }
+            }
+            store_chunk(id, chunk);
+        }
+        return *this;
+    }
+    //@}
+
+    /**
+     * @name Size and shape
+     */
+    //@{
+    /**
+     * Returns the size of the store.
+     */
+    template <class T>
+    inline auto xchunked_store<T>::size() const noexcept -> size_type
+    {
+        return compute_size(m_shape);
+    }
+
+    /**
+     * Returns the number of dimensions of the store.
+     */
+    template <class T>
+    inline auto xchunked_store<T>::dimension() const noexcept -> size_type
+    {
+        return m_shape.size();
+    }
+
+    /**
+     * Returns the shape of the store.
+     */
+    template <class T>
+    inline auto xchunked_store<T>::shape() const noexcept -> const inner_shape_type&
+    {
+        return m_shape;
+    }
+
+    /**
+     * Returns the shape of a chunk of the store.
+     */
+    template <class T>
+    inline auto xchunked_store<T>::chunk_shape() const noexcept -> const inner_shape_type&
+    {
+        return m_chunk_shape;
+    }
+
+    template <class T>
+    inline xt::layout xchunked_store<T>::layout() const noexcept
+    {
+        return layout_type;
+    }
+
+    /**
+     * Returns the directory of the store.
+     */
+    template <class T>
+    inline auto xchunked_store<T>::path() const noexcept -> const std::string&
+    {
+        return m_path;
+    }
+
+    /**
+     * Returns the codecs and cache settings of the store.
+     */
+    template <class T>
+    inline auto xchunked_store<T>::options() const noexcept -> const xchunk_store_options&
+    {
+        return m_options;
+    }
+    //@}
+
+    /**
+     * @name Data
+     */
+    //@{
+    /**
+     * Returns the element at the specified position in the store, loading
+     * the chunk holding it if it is not cached.
+     * @param args a list of indices specifying the position in the store. Indices
+     * must be unsigned integers, the number of indices should be equal or greater than
+     * the number of dimensions of the store.
+     */
+    template <class T>
+    template <class... Args>
+    inline auto xchunked_store<T>::operator()(Args... args) const -> const_reference
+    {
+        XTENSOR_ASSERT(check_index(shape(), args...));
+        std::array<size_type, sizeof...(Args)> index = {static_cast<size_type>(args)...};
+        return element(index.cbegin(), index.cend());
+    }
+
+    template <class T>
+    inline auto xchunked_store<T>::operator[](const xindex& index) const -> const_reference
+    {
+        return element(index.cbegin(), index.cend());
+    }
+
+    /**
+     * Returns the element at the specified position in the store.
+     * @param first iterator starting the sequence of indices
+     * @param last iterator ending the sequence of indices
+     * The number of indices in the squence should be equal to or greater
+     * than the number of dimensions of the store.
+     */
+    template <class T>
+    template <class It>
+    inline auto xchunked_store<T>::element(It first, It last) const -> const_reference
+    {
+        XTENSOR_ASSERT(check_element_index(shape(), first, last));
+        std::advance(first, std::distance(first, last) - static_cast<difference_type>(dimension()));
+        size_type id = 0;
+        size_type offset = 0;
+        for (size_type d = 0; d < dimension(); ++d, ++first)
+        {
+            size_type i = static_cast<size_type>(*first);
+            id = id * m_grid_shape[d] + i / m_chunk_shape[d];
+            offset += (i % m_chunk_shape[d]) * m_chunk_strides[d];
+        }
+        return get_chunk(id)[offset];
+    }
+    //@}
+
+    /**
+     * @name Broadcasting
+     */
+    //@{
+    /**
+     * Broadcast the shape of the store to the specified parameter.
+     * @param shape the result shape
+     * @return a boolean indicating whether the broadcasting is trivial
+     */
+    template <class T>
+    template <class O>
+    inline bool xchunked_store<T>::broadcast_shape(O& shape) const
+    {
+        return xt::broadcast_shape(m_shape, shape);
+    }
+
+    /**
+     * Compares the specified strides with those of the store to see whether
+     * the broadcasting is trivial.
+     * @return a boolean indicating whether the broadcasting is trivial
+     */
+    template <class T>
+    template <class O>
+    inline bool xchunked_store<T>::is_trivial_broadcast(const O& /*strides*/) const noexcept
+    {
+        return false;
+    }
+    //@}
+
+    template <class T>
+    template <class O>
+    inline auto xchunked_store<T>::stepper_begin(const O& shape) const noexcept -> const_stepper
+    {
+        size_type offset = shape.size() - dimension();
+        return const_stepper(this, offset);
+    }
+
+    template <class T>
+    template <class O>
+    inline auto xchunked_store<T>::stepper_end(const O& shape) const noexcept -> const_stepper
+    {
+        size_type offset = shape.size() - dimension();
+        return const_stepper(this, offset, true);
+    }
+
+    template <class T>
+    inline void xchunked_store<T>::init_grid()
+    {
+        size_type dim = dimension();
+        m_grid_shape.resize(dim);
+        m_chunk_strides.resize(dim);
+        m_chunk_size = 1;
+        for (size_type d = dim; d != 0; --d)
+        {
+            m_grid_shape[d - 1] = (m_shape[d - 1] + m_chunk_shape[d - 1] - 1) / m_chunk_shape[d - 1];
+            m_chunk_strides[d - 1] = m_chunk_size;
+            m_chunk_size *= m_chunk_shape[d - 1];
+        }
+        if (m_options.cache_size == 0)
+        {
+            m_options.cache_size = 1;
+        }
+    }
+
+    template <class T>
+    inline void xchunked_store<T>::write_metadata() const
+    {
+        std::ofstream out(m_path + "/" + detail::chunk_store_metadata);
+        if (!out)
+        {
+            throw std::runtime_error("Cannot write chunked store metadata in " + m_path);
+        }
+        out << "xchunk_store " << detail::chunk_store_version << '\n';
+        out << "dtype " << dtype_kind<value_type>() << sizeof(value_type) << '\n';
+        detail::write_sequence_line(out, "shape", m_shape);
+        detail::write_sequence_line(out, "chunks", m_chunk_shape);
+        out << "codecs " << m_options.shuffle << ' ' << m_options.delta << ' ' << m_options.compress << '\n';
+    }
+
+    template <class T>
+    inline void xchunked_store<T>::read_metadata()
+    {
+        std::ifstream in(m_path + "/" + detail::chunk_store_metadata);
+        if (!in)
+        {
+            throw std::runtime_error("Cannot read chunked store metadata in " + m_path);
+        }
+        std::string key;
+        int version = 0;
+        in >> key >> version;
+        if (key != "xchunk_store" || version != detail::chunk_store_version)
+        {
+            throw std::runtime_error("Unsupported chunked store format in " + m_path);
+        }
+        std::string dtype;
+        in >> key >> dtype;
+        std::string expected = dtype_kind<value_type>() + std::to_string(sizeof(value_type));
+        if (key != "dtype" || dtype != expected)
+        {
+            throw std::runtime_error("Chunked store value type " + dtype + " does not match " + expected);
+        }
+        detail::read_sequence_line(in, "shape", m_shape);
+        detail::read_sequence_line(in, "chunks", m_chunk_shape);
+        in >> key >> m_options.shuffle >> m_options.delta >> m_options.compress;
+        if (!in || key != "codecs" || m_shape.size() != m_chunk_shape.size() ||
+            std::find(m_chunk_shape.cbegin(), m_chunk_shape.cend(), size_type(0)) != m_chunk_shape.cend())
+        {
+            throw std::runtime_error("Invalid chunked store metadata in " + m_path);
+        }
+    }
+
+    template <class T>
+    inline std::string xchunked_store<T>::chunk_path(const shape_type& chunk_index) const
+    {
+        std::ostringstream name;
+        name << m_path << '/';
+        if (chunk_index.empty())
+        {
+            name << '0';
+        }
+        for (size_type d = 0; d < chunk_index.size(); ++d)
+        {
+            name << (d == 0 ? "" : ".") << chunk_index[d];
+        }
+        return name.str();
+    }
+
+    template <class T>
+    inline auto xchunked_store<T>::chunk_coordinates(size_type id) const -> shape_type
+    {
+        shape_type coords(dimension());
+        for (size_type d = dimension(); d != 0; --d)
+        {
+            coords[d - 1] = id % m_grid_shape[d - 1];
+            id /= m_grid_shape[d - 1];
+        }
+        return coords;
+    }
+
+    template <class T>
+    inline auto xchunked_store<T>::get_chunk(size_type id) const -> const chunk_type&
+    {
+        // Fast path: consecutive accesses mostly hit the same chunk
+        if (!m_cache.empty() && m_cache.front().first == id)
+        {
+            return m_cache.front().second;
+        }
+        auto it = m_cache_index.find(id);
+        if (it != m_cache_index.end())
+        {
+            m_cache.splice(m_cache.begin(), m_cache, it->second);
+            return m_cache.front().second;
+        }
+        insert_chunk(id, load_chunk(id));
+        return m_cache.front().second;
+    }
+
+    template <class T>
+    inline void xchunked_store<T>::insert_chunk(size_type id, chunk_type&& chunk) const
+    {
+        auto it = m_cache_index.find(id);
+        if (it != m_cache_index.end())
+        {
+            m_cache.erase(it->second);
+            m_cache_index.erase(it);
+        }
+        while (m_cache.size() >= m_options.cache_size)
+        {
+            m_cache_index.erase(m_cache.back().first);
+            m_cache.pop_back();
+        }
+        m_cache.emplace_front(id, std::move(chunk));
+        m_cache_index[id] = m_cache.begin();
+    }
+
+    template <class T>
+    inline auto xchunked_store<T>::load_chunk(size_type id) const -> chunk_type
+    {
+        chunk_type chunk(m_chunk_size, value_type(0));
+        std::ifstream in(chunk_path(chunk_coordinates(id)), std::ios::binary);
+        if (!in)
+        {
+            return chunk;
+        }
+
+        size_type nbytes = m_chunk_size * sizeof(value_type);
+        std::uint64_t raw_size = detail::read_uint64(in);
+        char compressed = 0;
+        in.get(compressed);
+        if (!in || raw_size != nbytes)
+        {
+            throw std::runtime_error("Corrupted chunk file " + chunk_path(chunk_coordinates(id)));
+        }
+        std::string encoded((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+        std::vector<char> buf(nbytes);
+        if (compressed)
+        {
+            detail::lz_decompress(encoded.data(), encoded.size(), buf.data(), nbytes);
+        }
+        else if (encoded.size() == nbytes)
+        {
+            std::copy(encoded.cbegin(), encoded.cend(), buf.begin());
+        }
+        else
+        {
+            throw std::runtime_error("Corrupted chunk file " + chunk_path(chunk_coordinates(id)));
+        }
+
+        if (m_options.delta)
+        {
+            detail::delta_decode(buf.data(), nbytes);
+        }
+        char* dst = reinterpret_cast<char*>(chunk.data());
+        if (m_options.shuffle && sizeof(value_type) > 1)
+        {
+            detail::byte_unshuffle(buf.data(), dst, m_chunk_size, sizeof(value_type));
+        }
+        else
+        {
+            std::memcpy(dst, buf.data(), nbytes);
+        }
+        return chunk;
+    }
+
+    template <class T>
+    inline void xchunked_store<T>::store_chunk(size_type id, const chunk_type& chunk)
+    {
+        size_type nbytes = m_chunk_size * sizeof(value_type);
+        std::vector<char> buf(nbytes);
+        const char* src = reinterpret_cast<const char*>(chunk.data());
+        if (m_options.shuffle && sizeof(value_type) > 1)
+        {
+            detail::byte_shuffle(src, buf.data(), m_chunk_size, sizeof(value_type));
+        }
+        else
+        {
+            std::memcpy(buf.data(), src, nbytes);
+        }
+        if (m_options.delta)
+        {
+            detail::delta_encode(buf.data(), nbytes);
+        }
+
+        std::string path = chunk_path(chunk_coordinates(id));
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            throw std::runtime_error("Cannot write chunk file " + path);
+        }
+        detail::write_uint64(out, nbytes);
+        std::string compressed;
+        if (m_options.compress)
+        {
+            compressed = detail::lz_compress(buf.data(), nbytes);
+        }
+        if (m_options.compress && compressed.size() < nbytes)
+        {
+            out.put(1);
+            out.write(compressed.data(), static_cast<std::streamsize>(compressed.size()));
+        }
+        else
+        {
+            out.put(0);
+            out.write(buf.data(), static_cast<std::streamsize>(nbytes));
+        }
+        if (!out)
+        {
+            throw std::runtime_error("Cannot write chunk file " + path);
+        }
+
+        if (m_cache_index.find(id) != m_cache_index.end())
+        {
+            insert_chunk(id, chunk_type(chunk));
+        }
+    }
+
+    /**
+     * @brief Creates a chunked store.
+     *
+     * Creates a new chunked store of value type \c T in the directory \c path,
+     * which must not already hold a chunked store.
+     * @param path the directory of the store
+     * @param shape the shape of the store
+     * @param chunk_shape the shape of a chunk
+     * @param options the codecs and cache settings
+     * @return a handle on the new store, whose elements are all zero
+     */
+    template <class T>
+    inline xchunked_store<T> create_chunked_store(const std::string& path,
+                                                  const std::vector<std::size_t>& shape,
+                                                  const std::vector<std::size_t>& chunk_shape,
+                                                  const xchunk_store_options& options)
+    {
+        return xchunked_store<T>(path, shape, chunk_shape, options);
+    }
+
+    /**
+     * @brief Opens a chunked store.
+     *
+     * Opens the chunked store in the directory \c path. The value type \c T
+     * must match the one the store was created with.
+     * @param path the directory of the store
+     * @return a handle on the store
+     */
+    template <class T>
+    inline xchunked_store<T> open_chunked_store(const std::string& path)
+    {
+        return xchunked_store<T>(path);
+    }
+}
+
+#endif
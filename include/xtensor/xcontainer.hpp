@@ -23,16 +23,6 @@
 namespace xt
 {
 
-    namespace check_policy
-    {
-        struct none
-        {
-        };
-        struct full
-        {
-        };
-    }
-
     template <class D>
     struct xcontainer_iterable_types
     {
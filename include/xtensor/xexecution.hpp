@@ -0,0 +1,622 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XEXECUTION_HPP
+#define XEXECUTION_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(XTENSOR_USE_TBB)
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+#endif
+
+namespace xt
+{
+
+    /**
+     * @enum execution_policy
+     * @brief Execution policy of the assignment loops.
+     */
+    enum class execution_policy
+    {
+        sequential, /*! loops run in the calling thread */
+        parallel /*! loops are split among the threads of the executor */
+    };
+
+    class xthread_pool;
+
+    xthread_pool& default_thread_pool();
+
+    namespace execution_options
+    {
+        struct execution_options_impl
+        {
+            execution_policy policy = execution_policy::sequential;
+            std::size_t nb_threads = std::max(std::thread::hardware_concurrency(), 1u);
+            std::size_t grain_size = 16384;
+            bool deterministic_reduction = false;
+            std::size_t reduction_block_size = 4096;
+        };
+
+        inline execution_options_impl& execution_options()
+        {
+            static execution_options_impl eo;
+            return eo;
+        }
+
+        /**
+         * @brief Sets the execution policy of the assignment loops
+         *        (default: sequential).
+         *
+         * @param policy The execution policy
+         */
+        inline void set_policy(execution_policy policy)
+        {
+            execution_options().policy = policy;
+        }
+
+        /**
+         * @brief Sets the number of threads taking part in parallel loops,
+         *        including the calling thread (default: the number of
+         *        hardware threads). Must not be called while a parallel
+         *        loop is running.
+         *
+         * @param nb_threads The number of threads
+         */
+        inline void set_nb_threads(std::size_t nb_threads);
+
+        /**
+         * @brief Sets the minimal number of elements processed by a task
+         *        (default: 16384). Smaller loops run sequentially.
+         *
+         * @param grain_size The number of elements
+         */
+        inline void set_grain_size(std::size_t grain_size)
+        {
+            execution_options().grain_size = std::max(grain_size, std::size_t(1));
+        }
+
+        /**
+         * @brief Enables the deterministic reduction mode (default: disabled).
+         *
+         * In this mode, reductions over more than reduction_block_size
+         * elements accumulate fixed-size blocks of elements, then combine
+         * the partial results pairwise in a fixed order. The result only
+         * depends on the data and on the block size: it is the same for
+         * any execution policy and number of threads, while the blocks
+         * can be reduced in parallel.
+         *
+         * @param deterministic Whether the mode is enabled
+         */
+        inline void set_deterministic_reduction(bool deterministic)
+        {
+            execution_options().deterministic_reduction = deterministic;
+        }
+
+        /**
+         * @brief Sets the number of elements accumulated sequentially by
+         *        a block of the deterministic reduction mode (default: 4096).
+         *        Results are only reproducible for a same block size.
+         *
+         * @param block_size The number of elements
+         */
+        inline void set_reduction_block_size(std::size_t block_size)
+        {
+            execution_options().reduction_block_size = std::max(block_size, std::size_t(1));
+        }
+    }
+
+    /****************
+     * xthread_pool *
+     ****************/
+
+    namespace detail
+    {
+        class work_queue;
+    }
+
+    /**
+     * @class xthread_pool
+     * @brief Work-stealing pool of worker threads.
+     *
+     * The xthread_pool class owns a fixed set of worker threads, started
+     * once and reused by all parallel loops. Each worker has its own deque
+     * of tasks: it pops the tasks it spawned from the back and steals from
+     * the front of the other deques when its own is empty. Threads outside
+     * the pool submit to a shared queue.
+     *
+     * The thread calling parallel_for takes part in the loop and, once no
+     * block is left, runs pending tasks until its helpers are done. Nested
+     * parallel loops thus spread over the idle workers without spawning
+     * threads, and never block a worker on a task nobody runs.
+     */
+    class xthread_pool
+    {
+
+    public:
+
+        explicit xthread_pool(std::size_t nb_workers = 0);
+        ~xthread_pool();
+
+        xthread_pool(const xthread_pool&) = delete;
+        xthread_pool& operator=(const xthread_pool&) = delete;
+
+        std::size_t size() const noexcept;
+        void resize(std::size_t nb_workers);
+
+        template <class F>
+        void parallel_for(std::size_t first, std::size_t last, std::size_t grain, F&& f);
+
+    private:
+
+        void start(std::size_t nb_workers);
+        void stop();
+        std::size_t worker_index() const noexcept;
+        void submit(std::function<void()> task);
+        bool try_run_one(std::size_t self);
+        void worker_loop(std::size_t index);
+
+        std::vector<std::thread> m_workers;
+        std::vector<std::unique_ptr<detail::work_queue>> m_queues;
+        std::unique_ptr<detail::work_queue> m_global;
+        std::atomic<std::size_t> m_nb_pending;
+        std::mutex m_mutex;
+        std::condition_variable m_cv;
+        bool m_stop;
+    };
+
+    template <class F>
+    void parallel_for(std::size_t first, std::size_t last, std::size_t grain, F&& f);
+
+    /*******************************
+     * xthread_pool implementation *
+     *******************************/
+
+    namespace detail
+    {
+        // Pool and index of the worker running on the current thread
+        struct worker_slot
+        {
+            const void* pool = nullptr;
+            std::size_t index = std::size_t(-1);
+        };
+
+        inline worker_slot& current_worker() noexcept
+        {
+            static thread_local worker_slot slot;
+            return slot;
+        }
+
+        class work_queue
+        {
+
+        public:
+
+            void push(std::function<void()> task)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_tasks.push_back(std::move(task));
+            }
+
+            bool pop_back(std::function<void()>& task)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_tasks.empty())
+                {
+                    return false;
+                }
+                task = std::move(m_tasks.back());
+                m_tasks.pop_back();
+                return true;
+            }
+
+            bool pop_front(std::function<void()>& task)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_tasks.empty())
+                {
+                    return false;
+                }
+                task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+                return true;
+            }
+
+        private:
+
+            std::deque<std::function<void()>> m_tasks;
+            std::mutex m_mutex;
+        };
+
+        class parallel_for_state
+        {
+
+        public:
+
+            explicit parallel_for_state(std::size_t nb_helpers)
+                : m_next(0), m_nb_helpers(nb_helpers), m_failed(false)
+            {
+            }
+
+            std::size_t next_block() noexcept
+            {
+                return m_failed.load() ? std::size_t(-1) : m_next.fetch_add(1);
+            }
+
+            void set_error(std::exception_ptr error)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (!m_error)
+                {
+                    m_error = error;
+                }
+                m_failed.store(true);
+            }
+
+            // The waiting thread may destroy the state as soon as the count
+            // drops to zero, hence the notification under the lock.
+            void helper_done()
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                --m_nb_helpers;
+                m_cv.notify_all();
+            }
+
+            template <class H>
+            void wait(H&& help)
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                while (m_nb_helpers != 0)
+                {
+                    lock.unlock();
+                    bool helped = help();
+                    lock.lock();
+                    if (!helped)
+                    {
+                        m_cv.wait_for(lock, std::chrono::microseconds(200), [this]() { return m_nb_helpers == 0; });
+                    }
+                }
+                if (m_error)
+                {
+                    std::rethrow_exception(m_error);
+                }
+            }
+
+        private:
+
+            std::atomic<std::size_t> m_next;
+            std::size_t m_nb_helpers;
+            std::atomic<bool> m_failed;
+            std::exception_ptr m_error;
+            std::mutex m_mutex;
+            std::condition_variable m_cv;
+        };
+    }
+
+    /**
+     * Starts a pool with the specified number of worker threads.
+     * @param nb_workers the number of workers
+     */
+    inline xthread_pool::xthread_pool(std::size_t nb_workers)
+        : m_global(std::make_unique<detail::work_queue>()), m_nb_pending(0), m_stop(false)
+    {
+        start(nb_workers);
+    }
+
+    /**
+     * Joins the worker threads.
+     */
+    inline xthread_pool::~xthread_pool()
+    {
+        stop();
+    }
+
+    /**
+     * Returns the number of worker threads.
+     */
+    inline std::size_t xthread_pool::size() const noexcept
+    {
+        return m_workers.size();
+    }
+
+    /**
+     * Restarts the pool with the specified number of worker threads. Must
+     * not be called while a parallel loop is running.
+     * @param nb_workers the new number of workers
+     */
+    inline void xthread_pool::resize(std::size_t nb_workers)
+    {
+        if (nb_workers != size())
+        {
+            stop();
+            start(nb_workers);
+        }
+    }
+
+    /**
+     * Calls \c f(b, e) on consecutive blocks [b, e) covering [first, last),
+     * using the workers of the pool and the calling thread. Blocks hold at
+     * least \c grain indices. The first exception thrown by \c f is rethrown
+     * once all the running blocks are done. Calls from within a task of the
+     * pool are parallelized as well.
+     * @param first the first index of the range
+     * @param last the index following the last index of the range
+     * @param grain the minimal size of a block
+     * @param f the function to call on each block
+     */
+    template <class F>
+    inline void xthread_pool::parallel_for(std::size_t first, std::size_t last, std::size_t grain, F&& f)
+    {
+        if (last <= first)
+        {
+            return;
+        }
+        std::size_t n = last - first;
+        std::size_t nb_tasks = std::min((n + grain - 1) / std::max(grain, std::size_t(1)), size() + 1);
+        if (nb_tasks <= 1)
+        {
+            f(first, last);
+            return;
+        }
+
+        // A few blocks per task balance uneven block costs
+        std::size_t block_size = std::max(grain, (n + 4 * nb_tasks - 1) / (4 * nb_tasks));
+        std::size_t nb_blocks = (n + block_size - 1) / block_size;
+        detail::parallel_for_state state(nb_tasks - 1);
+        auto run = [&state, &f, first, last, block_size, nb_blocks]() {
+            std::size_t b;
+            while ((b = state.next_block()) < nb_blocks)
+            {
+                try
+                {
+                    f(first + b * block_size, std::min(last, first + (b + 1) * block_size));
+                }
+                catch (...)
+                {
+                    state.set_error(std::current_exception());
+                }
+            }
+        };
+        for (std::size_t i = 0; i + 1 < nb_tasks; ++i)
+        {
+            submit([&state, &run]() {
+                run();
+                state.helper_done();
+            });
+        }
+        run();
+        std::size_t self = worker_index();
+        state.wait([this, self]() { return try_run_one(self); });
+    }
+
+    inline void xthread_pool::start(std::size_t nb_workers)
+    {
+        m_stop = false;
+        m_queues.clear();
+        for (std::size_t i = 0; i < nb_workers; ++i)
+        {
+            m_queues.push_back(std::make_unique<detail::work_queue>());
+        }
+        m_workers.reserve(nb_workers);
+        for (std::size_t i = 0; i < nb_workers; ++i)
+        {
+            m_workers.emplace_back([this, i]() { worker_loop(i); });
+        }
+    }
+
+    inline void xthread_pool::stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_cv.notify_all();
+        for (auto& w : m_workers)
+        {
+            w.join();
+        }
+        m_workers.clear();
+    }
+
+    inline std::size_t xthread_pool::worker_index() const noexcept
+    {
+        const detail::worker_slot& slot = detail::current_worker();
+        return slot.pool == this ? slot.index : std::size_t(-1);
+    }
+
+    inline void xthread_pool::submit(std::function<void()> task)
+    {
+        std::size_t self = worker_index();
+        if (self < m_queues.size())
+        {
+            m_queues[self]->push(std::move(task));
+        }
+        else
+        {
+            m_global->push(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_nb_pending;
+        }
+        m_cv.notify_one();
+    }
+
+    // Runs the most recent task of the own deque, else the oldest task of
+    // the shared queue, else steals the oldest task of another worker.
+    inline bool xthread_pool::try_run_one(std::size_t self)
+    {
+        std::function<void()> task;
+        bool found = self < m_queues.size() && m_queues[self]->pop_back(task);
+        if (!found)
+        {
+            found = m_global->pop_front(task);
+        }
+        std::size_t nb_queues = m_queues.size();
+        for (std::size_t i = 1; !found && i <= nb_queues; ++i)
+        {
+            std::size_t victim = (self + i) % nb_queues;
+            found = victim != self && m_queues[victim]->pop_front(task);
+        }
+        if (found)
+        {
+            --m_nb_pending;
+            task();
+        }
+        return found;
+    }
+
+    inline void xthread_pool::worker_loop(std::size_t index)
+    {
+        detail::current_worker().pool = this;
+        detail::current_worker().index = index;
+        while (true)
+        {
+            if (try_run_one(index))
+            {
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this]() { return m_stop || m_nb_pending.load() != 0; });
+            if (m_stop && m_nb_pending.load() == 0)
+            {
+                return;
+            }
+        }
+    }
+
+    /**
+     * Returns the pool used by the parallel loops of xtensor. It is started
+     * on first use, with one worker less than the number of threads set in
+     * execution_options, the calling thread taking part in the loops.
+     */
+    inline xthread_pool& default_thread_pool()
+    {
+        static xthread_pool pool(execution_options::execution_options().nb_threads - 1);
+        return pool;
+    }
+
+#if defined(XTENSOR_USE_TBB)
+    /**
+     * Returns the TBB arena in which the parallel loops of xtensor run. It is
+     * initialized on first use with the number of threads set in
+     * execution_options, and rebuilt only when that number changes.
+     */
+    inline tbb::task_arena& default_task_arena()
+    {
+        static tbb::task_arena arena(static_cast<int>(execution_options::execution_options().nb_threads));
+        return arena;
+    }
+#endif
+
+    namespace execution_options
+    {
+        inline void set_nb_threads(std::size_t nb_threads)
+        {
+            nb_threads = std::max(nb_threads, std::size_t(1));
+#if defined(XTENSOR_USE_TBB)
+            if (nb_threads != execution_options().nb_threads)
+            {
+                tbb::task_arena& arena = default_task_arena();
+                arena.terminate();
+                arena.initialize(static_cast<int>(nb_threads));
+            }
+#endif
+            execution_options().nb_threads = nb_threads;
+#if !defined(XTENSOR_USE_TBB) && !defined(XTENSOR_USE_OPENMP)
+            default_thread_pool().resize(nb_threads - 1);
+#endif
+        }
+    }
+
+    /*******************************
+     * parallel_for implementation *
+     *******************************/
+
+    /**
+     * @brief Parallel loop over a range of indices.
+     *
+     * Calls \c f(b, e) on consecutive blocks [b, e) covering [first, last),
+     * with the backend selected at configure time: TBB if \c XTENSOR_USE_TBB
+     * is defined, OpenMP if \c XTENSOR_USE_OPENMP is defined, and the default
+     * xthread_pool otherwise. The number of threads is taken from execution_options.
+     * @param first the first index of the range
+     * @param last the index following the last index of the range
+     * @param grain the minimal size of a block
+     * @param f the function to call on each block
+     */
+    template <class F>
+    inline void parallel_for(std::size_t first, std::size_t last, std::size_t grain, F&& f)
+    {
+        if (last <= first)
+        {
+            return;
+        }
+        grain = std::max(grain, std::size_t(1));
+#if defined(XTENSOR_USE_TBB)
+        default_task_arena().execute([&]() {
+            tbb::parallel_for(tbb::blocked_range<std::size_t>(first, last, grain),
+                              [&f](const tbb::blocked_range<std::size_t>& r) { f(r.begin(), r.end()); });
+        });
+#elif defined(XTENSOR_USE_OPENMP)
+        std::size_t nb_blocks = (last - first + grain - 1) / grain;
+        int nb_threads = static_cast<int>(execution_options::execution_options().nb_threads);
+        std::exception_ptr error;
+#pragma omp parallel for schedule(dynamic) num_threads(nb_threads)
+        for (std::ptrdiff_t b = 0; b < static_cast<std::ptrdiff_t>(nb_blocks); ++b)
+        {
+            std::size_t begin = first + static_cast<std::size_t>(b) * grain;
+            try
+            {
+                f(begin, std::min(last, begin + grain));
+            }
+            catch (...)
+            {
+#pragma omp critical(xtensor_parallel_for)
+                {
+                    if (!error)
+                    {
+                        error = std::current_exception();
+                    }
+                }
+            }
+        }
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+#else
+        default_thread_pool().parallel_for(first, last, grain, std::forward<F>(f));
+#endif
+    }
+
+    namespace detail
+    {
+        // Whether a loop over size elements should run in parallel
+        inline bool use_parallel(std::size_t size) noexcept
+        {
+            const auto& eo = execution_options::execution_options();
+            return eo.policy == execution_policy::parallel && eo.nb_threads > 1 && size >= 2 * eo.grain_size;
+        }
+    }
+}
+
+#endif
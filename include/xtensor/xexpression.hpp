@@ -155,6 +155,73 @@ namespace xt
     template <class E>
     using const_xclosure_t = typename const_xclosure<E>::type;
 
+    /***********************
+     * is_cheap_expression *
+     ***********************/
+
+    /**
+     * Tells whether the elements of an expression are computed in closed
+     * form, without referring to other expressions. Such an expression
+     * cannot alias the destination of an assignment, which is therefore
+     * evaluated in place, without a temporary.
+     */
+    template <class E>
+    struct is_cheap_expression : std::false_type
+    {
+    };
+
+    /****************************
+     * is_concurrently_readable *
+     ****************************/
+
+    /**
+     * Tells whether the elements of an expression can be read from several
+     * threads at once. Expressions opt in when reading an element does not
+     * modify any state, neither their own nor that of their operands; the
+     * others are only evaluated by the calling thread.
+     */
+    template <class E>
+    struct is_concurrently_readable : std::false_type
+    {
+    };
+
+    /**
+     * Tells whether a functor can be called from several threads at once.
+     * Stateless (empty) functors can; the others opt in by declaring a
+     * static \c is_concurrently_callable member set to true.
+     */
+    template <class F, class = void>
+    struct is_concurrently_callable : std::is_empty<F>
+    {
+    };
+
+    template <class F>
+    struct is_concurrently_callable<F, std::enable_if_t<F::is_concurrently_callable>> : std::true_type
+    {
+    };
+
+    /***********************
+     * has_nonzero_columns *
+     ***********************/
+
+    /**
+     * Tells whether a 2-D expression describes its structural zeros. Such an
+     * expression provides a member \c nonzero_columns(row) returning the
+     * half-open range of columns out of which the elements of the row are
+     * zero, so that assignments and products can skip the zero region.
+     */
+    template <class E>
+    struct has_nonzero_columns
+    {
+        template <class T>
+        static auto test(int) -> decltype(std::declval<const T&>().nonzero_columns(std::size_t(0)), std::true_type());
+
+        template <class T>
+        static std::false_type test(...);
+
+        static constexpr bool value = decltype(test<E>(0))::value;
+    };
+
     /***************
      * xvalue_type *
      ***************/
@@ -0,0 +1,904 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XFILE_ARRAY_HPP
+#define XFILE_ARRAY_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <fstream>
+#include <future>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "xexpression.hpp"
+#include "xiterable.hpp"
+#include "xserialize.hpp"
+#include "xstrides.hpp"
+#include "xutils.hpp"
+
+namespace xt
+{
+
+    namespace detail
+    {
+        template <class T>
+        class file_window;
+    }
+
+    /***************
+     * xfile_array *
+     ***************/
+
+    template <class T>
+    class xfile_array;
+
+    template <class T>
+    class xfile_stepper;
+
+    template <class T>
+    struct xiterable_inner_types<xfile_array<T>>
+    {
+        using inner_shape_type = std::vector<std::size_t>;
+        using const_stepper = xfile_stepper<T>;
+        using stepper = const_stepper;
+        using const_broadcast_iterator = xiterator<const_stepper, inner_shape_type*>;
+        using broadcast_iterator = const_broadcast_iterator;
+        using const_iterator = const_broadcast_iterator;
+        using iterator = const_iterator;
+    };
+
+    /**
+     * @class xfile_array
+     * @brief Read-only expression over an array stored in a file.
+     *
+     * The xfile_array class represents an array stored on disk, either as
+     * raw binary data or in the NPY format, without loading it in memory.
+     * Its steppers read the file by windows of window_size() elements aligned
+     * on multiples of the window size, and keep the window_count() most
+     * recently used windows in a LRU cache. When a stepper enters a window,
+     * the next one in its direction of travel is read in the background, so
+     * that evaluating an expression involving xfile_array objects, or reducing
+     * them, overlaps reading the files with computing. Backward or strided
+     * traversals, such as a row-major traversal of a column-major file, reuse
+     * the windows already read.
+     *
+     * Each stepper owns its windows, so that several steppers can traverse
+     * the same file at different positions; random access through operator()
+     * or element uses windows owned by the expression.
+     *
+     * @tparam T the trivially copyable value type of the array
+     * @sa open_raw_file, open_npy_file
+     */
+    template <class T>
+    class xfile_array : public xexpression<xfile_array<T>>,
+                        public xexpression_const_iterable<xfile_array<T>>
+    {
+
+    public:
+
+        static_assert(std::is_trivially_copyable<T>::value, "file array value type must be trivially copyable");
+
+        using self_type = xfile_array<T>;
+
+        using value_type = T;
+        using reference = value_type;
+        using const_reference = value_type;
+        using pointer = value_type*;
+        using const_pointer = const value_type*;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        using iterable_base = xexpression_const_iterable<self_type>;
+        using inner_shape_type = typename iterable_base::inner_shape_type;
+        using shape_type = inner_shape_type;
+        using strides_type = shape_type;
+
+        using stepper = typename iterable_base::stepper;
+        using const_stepper = typename iterable_base::const_stepper;
+
+        using broadcast_iterator = typename iterable_base::broadcast_iterator;
+        using const_broadcast_iterator = typename iterable_base::const_broadcast_iterator;
+
+        using iterator = typename iterable_base::iterator;
+        using const_iterator = typename iterable_base::const_iterator;
+
+        static constexpr xt::layout layout_type = xt::layout::dynamic;
+        static constexpr bool contiguous_layout = true;
+
+        xfile_array(const std::string& path, const shape_type& shape,
+                    xt::layout l = xt::layout::row_major, size_type data_offset = 0,
+                    bool swap_bytes = false);
+
+        size_type size() const noexcept;
+        size_type dimension() const noexcept;
+        const inner_shape_type& shape() const noexcept;
+        const strides_type& strides() const noexcept;
+        const strides_type& backstrides() const noexcept;
+        xt::layout layout() const noexcept;
+
+        const std::string& path() const noexcept;
+        size_type data_offset() const noexcept;
+        bool swap_bytes() const noexcept;
+        size_type window_size() const noexcept;
+        void set_window_size(size_type n);
+        size_type window_count() const noexcept;
+        void set_window_count(size_type n);
+        size_type read_count() const noexcept;
+
+        template <class... Args>
+        const_reference operator()(Args... args) const;
+        const_reference operator[](const xindex& index) const;
+
+        template <class It>
+        const_reference element(It first, It last) const;
+
+        template <class O>
+        bool broadcast_shape(O& shape) const;
+
+        template <class O>
+        bool is_trivial_broadcast(const O& /*strides*/) const noexcept;
+
+        template <class O>
+        const_stepper stepper_begin(const O& shape) const;
+        template <class O>
+        const_stepper stepper_end(const O& shape) const;
+
+    private:
+
+        using window_type = detail::file_window<value_type>;
+
+        std::shared_ptr<window_type> make_window() const;
+
+        std::string m_path;
+        shape_type m_shape;
+        strides_type m_strides;
+        strides_type m_backstrides;
+        xt::layout m_layout;
+        size_type m_data_offset;
+        size_type m_window_size;
+        size_type m_window_count;
+        bool m_swap_bytes;
+        std::shared_ptr<typename window_type::counter_type> p_read_count;
+        mutable std::shared_ptr<window_type> p_window;
+    };
+
+    template <class T>
+    xfile_array<T> open_raw_file(const std::string& path, const std::vector<std::size_t>& shape,
+                                 xt::layout l = xt::layout::row_major, std::size_t data_offset = 0);
+
+    template <class T>
+    xfile_array<T> open_npy_file(const std::string& path);
+
+    /*****************
+     * xfile_stepper *
+     *****************/
+
+    template <class T>
+    class xfile_stepper
+    {
+
+    public:
+
+        using self_type = xfile_stepper<T>;
+        using xexpression_type = xfile_array<T>;
+
+        using value_type = typename xexpression_type::value_type;
+        using reference = typename xexpression_type::const_reference;
+        using pointer = typename xexpression_type::const_pointer;
+        using size_type = typename xexpression_type::size_type;
+        using difference_type = typename xexpression_type::difference_type;
+        using shape_type = typename xexpression_type::shape_type;
+
+        using window_type = detail::file_window<value_type>;
+
+        xfile_stepper() = default;
+        xfile_stepper(const xexpression_type* e, std::shared_ptr<window_type> window,
+                      size_type offset, bool end = false);
+
+        reference operator*() const;
+
+        void step(size_type dim, size_type n = 1);
+        void step_back(size_type dim, size_type n = 1);
+        void reset(size_type dim);
+
+        void to_end();
+
+        bool equal(const self_type& rhs) const;
+
+    private:
+
+        const xexpression_type* p_e;
+        std::shared_ptr<window_type> p_window;
+        size_type m_index;
+        size_type m_offset;
+    };
+
+    template <class T>
+    bool operator==(const xfile_stepper<T>& lhs, const xfile_stepper<T>& rhs);
+
+    template <class T>
+    bool operator!=(const xfile_stepper<T>& lhs, const xfile_stepper<T>& rhs);
+
+    /******************************
+     * file_window implementation *
+     ******************************/
+
+    namespace detail
+    {
+        template <class T>
+        class file_window
+        {
+
+        public:
+
+            using size_type = std::size_t;
+            using counter_type = std::atomic<size_type>;
+
+            file_window(const std::string& path, size_type data_offset, size_type size,
+                        size_type window_size, size_type window_count, bool swap_bytes,
+                        std::shared_ptr<counter_type> read_count);
+            ~file_window();
+
+            file_window(const file_window&) = delete;
+            file_window& operator=(const file_window&) = delete;
+
+            const T& get(size_type i);
+
+        private:
+
+            using block_type = std::vector<T>;
+            using block_list = std::list<std::pair<size_type, block_type>>;
+            using block_map = std::unordered_map<size_type, typename block_list::iterator>;
+
+            const block_type& get_block(size_type id);
+            void load(size_type id, block_type& block);
+            void prefetch(size_type id);
+            void read_block(std::ifstream& in, size_type id, block_type& block) const;
+
+            std::string m_path;
+            std::ifstream m_stream;
+            block_list m_blocks;
+            block_map m_block_index;
+            size_type m_data_offset;
+            size_type m_size;
+            size_type m_window_size;
+            size_type m_window_count;
+            const T* p_current;
+            size_type m_begin;
+            size_type m_end;
+            size_type m_last_id;
+            bool m_swap_bytes;
+            std::shared_ptr<counter_type> p_read_count;
+
+            // Background read of the block following the current one in the
+            // direction of travel; the stream is only used by that read
+            std::ifstream m_prefetch_stream;
+            block_type m_prefetch_block;
+            size_type m_prefetch_id;
+            std::future<void> m_prefetch;
+        };
+
+        template <class T>
+        inline file_window<T>::file_window(const std::string& path, size_type data_offset, size_type size,
+                                           size_type window_size, size_type window_count, bool swap_bytes,
+                                           std::shared_ptr<counter_type> read_count)
+            : m_path(path), m_data_offset(data_offset), m_size(size), m_window_size(window_size),
+              m_window_count(window_count), p_current(nullptr), m_begin(0), m_end(0), m_last_id(0),
+              m_swap_bytes(swap_bytes), p_read_count(std::move(read_count)), m_prefetch_id(0)
+        {
+        }
+
+        template <class T>
+        inline file_window<T>::~file_window()
+        {
+            if (m_prefetch.valid())
+            {
+                m_prefetch.wait();
+            }
+        }
+
+        template <class T>
+        inline const T& file_window<T>::get(size_type i)
+        {
+            if (i < m_begin || i >= m_end)
+            {
+                if (i >= m_size)
+                {
+                    throw std::out_of_range("index " + std::to_string(i) + " is out of bounds of file " + m_path);
+                }
+                size_type id = i / m_window_size;
+                const block_type& block = get_block(id);
+                p_current = block.data();
+                m_begin = id * m_window_size;
+                m_end = m_begin + block.size();
+                // Steppers mostly keep moving in the same direction
+                size_type nb_blocks = (m_size + m_window_size - 1) / m_window_size;
+                if (id >= m_last_id && id + 1 < nb_blocks)
+                {
+                    prefetch(id + 1);
+                }
+                else if (id < m_last_id && id != 0)
+                {
+                    prefetch(id - 1);
+                }
+                m_last_id = id;
+            }
+            return p_current[i - m_begin];
+        }
+
+        template <class T>
+        inline auto file_window<T>::get_block(size_type id) -> const block_type&
+        {
+            auto it = m_block_index.find(id);
+            if (it != m_block_index.end())
+            {
+                m_blocks.splice(m_blocks.begin(), m_blocks, it->second);
+                return m_blocks.front().second;
+            }
+            // Reload the least recently used block in place when the cache
+            // is full, so that streaming through a file does not allocate
+            if (m_blocks.size() >= m_window_count)
+            {
+                m_block_index.erase(m_blocks.back().first);
+                m_blocks.splice(m_blocks.begin(), m_blocks, std::prev(m_blocks.end()));
+                m_blocks.front().first = id;
+            }
+            else
+            {
+                m_blocks.emplace_front(id, block_type());
+            }
+            try
+            {
+                load(id, m_blocks.front().second);
+            }
+            catch (...)
+            {
+                m_blocks.pop_front();
+                throw;
+            }
+            m_block_index[id] = m_blocks.begin();
+            return m_blocks.front().second;
+        }
+
+        template <class T>
+        inline void file_window<T>::load(size_type id, block_type& block)
+        {
+            if (m_prefetch.valid() && m_prefetch_id == id)
+            {
+                // The evicted storage becomes the buffer of the next prefetch
+                m_prefetch.get();
+                std::swap(block, m_prefetch_block);
+                return;
+            }
+            if (!m_stream.is_open())
+            {
+                m_stream.open(m_path, std::ios::binary);
+                if (!m_stream)
+                {
+                    throw std::runtime_error("Cannot open file " + m_path);
+                }
+            }
+            read_block(m_stream, id, block);
+            ++(*p_read_count);
+        }
+
+        template <class T>
+        inline void file_window<T>::prefetch(size_type id)
+        {
+            if (m_block_index.find(id) != m_block_index.end() ||
+                (m_prefetch.valid() && m_prefetch_id == id))
+            {
+                return;
+            }
+            if (m_prefetch.valid())
+            {
+                // Drop the read of a block the stepper did not move to; an
+                // error would be raised again if that block is loaded later
+                m_prefetch.wait();
+                m_prefetch = std::future<void>();
+            }
+            m_prefetch_id = id;
+            ++(*p_read_count);
+            m_prefetch = std::async(std::launch::async, [this, id]() {
+                if (!m_prefetch_stream.is_open())
+                {
+                    m_prefetch_stream.open(m_path, std::ios::binary);
+                    if (!m_prefetch_stream)
+                    {
+                        throw std::runtime_error("Cannot open file " + m_path);
+                    }
+                }
+                read_block(m_prefetch_stream, id, m_prefetch_block);
+            });
+        }
+
+        template <class T>
+        inline void file_window<T>::read_block(std::ifstream& in, size_type id, block_type& block) const
+        {
+            // Windows are aligned on multiples of the window size, so that
+            // steppers moving backward or striding hit the same blocks
+            size_type first = id * m_window_size;
+            block.resize(std::min(m_window_size, m_size - first));
+            in.clear();
+            in.seekg(static_cast<std::streamoff>(m_data_offset + first * sizeof(T)));
+            in.read(reinterpret_cast<char*>(block.data()), static_cast<std::streamsize>(block.size() * sizeof(T)));
+            if (!in)
+            {
+                throw std::runtime_error("Unexpected end of file " + m_path);
+            }
+            if (m_swap_bytes)
+            {
+                std::size_t scalar_size = is_complex<T>::value ? sizeof(T) / 2 : sizeof(T);
+                swap_bytes(reinterpret_cast<char*>(block.data()), block.size() * sizeof(T) / scalar_size, scalar_size);
+            }
+        }
+    }
+
+    /******************************
+     * xfile_array implementation *
+     ******************************/
+
+    /**
+     * @name Constructor
+     */
+    //@{
+    /**
+     * Constructs an xfile_array over the raw data stored in the specified file.
+     * @param path the path of the file
+     * @param shape the shape of the array
+     * @param l the layout of the data in the file, row_major or column_major
+     * @param data_offset the position of the first element in the file, in bytes
+     * @param swap_bytes whether the data was written with the opposite endianness
+     */
+    template <class T>
+    inline xfile_array<T>::xfile_array(const std::string& path, const shape_type& shape,
+                                       xt::layout l, size_type data_offset, bool swap_bytes)
+        : m_path(path), m_shape(shape), m_strides(shape.size()), m_backstrides(shape.size()),
+          m_layout(l), m_data_offset(data_offset), m_window_size(size_type(1) << 16),
+          m_window_count(8), m_swap_bytes(swap_bytes),
+          p_read_count(std::make_shared<typename window_type::counter_type>(0))
+    {
+        if (m_layout != xt::layout::row_major && m_layout != xt::layout::column_major)
+        {
+            throw std::runtime_error("File arrays must be row_major or column_major");
+        }
+        compute_strides(m_shape, m_layout, m_strides, m_backstrides);
+    }
+    //@}
+
+    /**
+     * @name Size and shape
+     */
+    //@{
+    /**
+     * Returns the size of the array.
+     */
+    template <class T>
+    inline auto xfile_array<T>::size() const noexcept -> size_type
+    {
+        return compute_size(m_shape);
+    }
+
+    /**
+     * Returns the number of dimensions of the array.
+     */
+    template <class T>
+    inline auto xfile_array<T>::dimension() const noexcept -> size_type
+    {
+        return m_shape.size();
+    }
+
+    /**
+     * Returns the shape of the array.
+     */
+    template <class T>
+    inline auto xfile_array<T>::shape() const noexcept -> const inner_shape_type&
+    {
+        return m_shape;
+    }
+
+    /**
+     * Returns the strides of the array, in number of elements.
+     */
+    template <class T>
+    inline auto xfile_array<T>::strides() const noexcept -> const strides_type&
+    {
+        return m_strides;
+    }
+
+    /**
+     * Returns the backstrides of the array.
+     */
+    template <class T>
+    inline auto xfile_array<T>::backstrides() const noexcept -> const strides_type&
+    {
+        return m_backstrides;
+    }
+
+    /**
+     * Returns the layout of the data in the file.
+     */
+    template <class T>
+    inline xt::layout xfile_array<T>::layout() const noexcept
+    {
+        return m_layout;
+    }
+
+    /**
+     * Returns the path of the file.
+     */
+    template <class T>
+    inline auto xfile_array<T>::path() const noexcept -> const std::string&
+    {
+        return m_path;
+    }
+
+    /**
+     * Returns the position of the first element in the file, in bytes.
+     */
+    template <class T>
+    inline auto xfile_array<T>::data_offset() const noexcept -> size_type
+    {
+        return m_data_offset;
+    }
+
+    /**
+     * Returns whether the data is byte swapped when read.
+     */
+    template <class T>
+    inline bool xfile_array<T>::swap_bytes() const noexcept
+    {
+        return m_swap_bytes;
+    }
+
+    /**
+     * Returns the number of elements read at once by the steppers.
+     */
+    template <class T>
+    inline auto xfile_array<T>::window_size() const noexcept -> size_type
+    {
+        return m_window_size;
+    }
+
+    /**
+     * Sets the number of elements read at once by the steppers created
+     * afterwards.
+     * @param n the new window size
+     */
+    template <class T>
+    inline void xfile_array<T>::set_window_size(size_type n)
+    {
+        m_window_size = std::max(n, size_type(1));
+        p_window.reset();
+    }
+
+    /**
+     * Returns the maximum number of windows kept in memory by each stepper.
+     */
+    template <class T>
+    inline auto xfile_array<T>::window_count() const noexcept -> size_type
+    {
+        return m_window_count;
+    }
+
+    /**
+     * Sets the maximum number of windows kept in memory by the steppers
+     * created afterwards.
+     * @param n the new window count
+     */
+    template <class T>
+    inline void xfile_array<T>::set_window_count(size_type n)
+    {
+        m_window_count = std::max(n, size_type(1));
+        p_window.reset();
+    }
+
+    /**
+     * Returns the number of windows read or prefetched from the file so far
+     * by the array and its steppers.
+     */
+    template <class T>
+    inline auto xfile_array<T>::read_count() const noexcept -> size_type
+    {
+        return p_read_count->load();
+    }
+    //@}
+
+    /**
+     * @name Data
+     */
+    //@{
+    /**
+     * Returns the element at the specified position in the array.
+     * @param args a list of indices specifying the position in the array. Indices
+     * must be unsigned integers, the number of indices should be equal or greater than
+     * the number of dimensions of the array.
+     */
+    template <class T>
+    template <class... Args>
+    inline auto xfile_array<T>::operator()(Args... args) const -> const_reference
+    {
+        XTENSOR_ASSERT(check_index(shape(), args...));
+        std::array<size_type, sizeof...(Args)> index = {static_cast<size_type>(args)...};
+        return element(index.cbegin(), index.cend());
+    }
+
+    template <class T>
+    inline auto xfile_array<T>::operator[](const xindex& index) const -> const_reference
+    {
+        return element(index.cbegin(), index.cend());
+    }
+
+    /**
+     * Returns the element at the specified position in the array.
+     * @param first iterator starting the sequence of indices
+     * @param last iterator ending the sequence of indices
+     * The number of indices in the squence should be equal to or greater
+     * than the number of dimensions of the array.
+     */
+    template <class T>
+    template <class It>
+    inline auto xfile_array<T>::element(It first, It last) const -> const_reference
+    {
+        XTENSOR_ASSERT(check_element_index(shape(), first, last));
+        if (!p_window)
+        {
+            p_window = make_window();
+        }
+        return p_window->get(element_offset<size_type>(m_strides, first, last));
+    }
+    //@}
+
+    /**
+     * @name Broadcasting
+     */
+    //@{
+    /**
+     * Broadcast the shape of the array to the specified parameter.
+     * @param shape the result shape
+     * @return a boolean indicating whether the broadcasting is trivial
+     */
+    template <class T>
+    template <class O>
+    inline bool xfile_array<T>::broadcast_shape(O& shape) const
+    {
+        return xt::broadcast_shape(m_shape, shape);
+    }
+
+    /**
+     * Compares the specified strides with those of the array to see whether
+     * the broadcasting is trivial.
+     * @return a boolean indicating whether the broadcasting is trivial
+     */
+    template <class T>
+    template <class O>
+    inline bool xfile_array<T>::is_trivial_broadcast(const O& /*strides*/) const noexcept
+    {
+        return false;
+    }
+    //@}
+
+    template <class T>
+    template <class O>
+    inline auto xfile_array<T>::stepper_begin(const O& shape) const -> const_stepper
+    {
+        size_type offset = shape.size() - dimension();
+        return const_stepper(this, make_window(), offset);
+    }
+
+    template <class T>
+    template <class O>
+    inline auto xfile_array<T>::stepper_end(const O& shape) const -> const_stepper
+    {
+        size_type offset = shape.size() - dimension();
+        return const_stepper(this, nullptr, offset, true);
+    }
+
+    template <class T>
+    inline auto xfile_array<T>::make_window() const -> std::shared_ptr<window_type>
+    {
+        return std::make_shared<window_type>(m_path, m_data_offset, size(), m_window_size, m_window_count,
+                                             m_swap_bytes, p_read_count);
+    }
+
+    /********************************
+     * xfile_stepper implementation *
+     ********************************/
+
+    template <class T>
+    inline xfile_stepper<T>::xfile_stepper(const xexpression_type* e, std::shared_ptr<window_type> window,
+                                           size_type offset, bool end)
+        : p_e(e), p_window(std::move(window)), m_index(0), m_offset(offset)
+    {
+        if (end)
+        {
+            to_end();
+        }
+    }
+
+    template <class T>
+    inline auto xfile_stepper<T>::operator*() const -> reference
+    {
+        return p_window->get(m_index);
+    }
+
+    template <class T>
+    inline void xfile_stepper<T>::step(size_type dim, size_type n)
+    {
+        if (dim >= m_offset)
+        {
+            m_index += n * p_e->strides()[dim - m_offset];
+        }
+    }
+
+    template <class T>
+    inline void xfile_stepper<T>::step_back(size_type dim, size_type n)
+    {
+        if (dim >= m_offset)
+        {
+            m_index -= n * p_e->strides()[dim - m_offset];
+        }
+    }
+
+    template <class T>
+    inline void xfile_stepper<T>::reset(size_type dim)
+    {
+        if (dim >= m_offset)
+        {
+            m_index -= p_e->backstrides()[dim - m_offset];
+        }
+    }
+
+    template <class T>
+    inline void xfile_stepper<T>::to_end()
+    {
+        m_index = p_e->size();
+    }
+
+    template <class T>
+    inline bool xfile_stepper<T>::equal(const self_type& rhs) const
+    {
+        return p_e == rhs.p_e && m_index == rhs.m_index && m_offset == rhs.m_offset;
+    }
+
+    template <class T>
+    inline bool operator==(const xfile_stepper<T>& lhs, const xfile_stepper<T>& rhs)
+    {
+        return lhs.equal(rhs);
+    }
+
+    template <class T>
+    inline bool operator!=(const xfile_stepper<T>& lhs, const xfile_stepper<T>& rhs)
+    {
+        return !lhs.equal(rhs);
+    }
+
+    /***********************************
+     * open_raw_file and open_npy_file *
+     ***********************************/
+
+    namespace detail
+    {
+        inline std::string npy_header_value(const std::string& header, const std::string& key)
+        {
+            std::size_t pos = header.find("'" + key + "'");
+            if (pos == std::string::npos)
+            {
+                throw std::runtime_error("Missing key " + key + " in NPY header");
+            }
+            pos = header.find(':', pos);
+            std::size_t first = pos == std::string::npos ? pos : header.find_first_not_of(' ', pos + 1);
+            if (first == std::string::npos)
+            {
+                throw std::runtime_error("Invalid NPY header");
+            }
+            std::size_t last = header[first] == '(' ? header.find(')', first) : header.find_first_of(",}", first);
+            if (last == std::string::npos)
+            {
+                throw std::runtime_error("Invalid NPY header");
+            }
+            last += header[first] == '(' ? 1 : 0;
+            return header.substr(first, last - first);
+        }
+
+        inline std::vector<std::size_t> npy_parse_shape(const std::string& value)
+        {
+            std::vector<std::size_t> shape;
+            std::size_t pos = 1;
+            while (pos < value.size())
+            {
+                pos = value.find_first_of("0123456789", pos);
+                if (pos == std::string::npos)
+                {
+                    break;
+                }
+                std::size_t end = value.find_first_not_of("0123456789", pos);
+                shape.push_back(static_cast<std::size_t>(std::stoull(value.substr(pos, end - pos))));
+                pos = end;
+            }
+            return shape;
+        }
+    }
+
+    /**
+     * @brief Opens a raw binary file as an expression.
+     *
+     * Returns an xfile_array over the elements of type \c T stored contiguously
+     * in the file \c path, in the native byte order.
+     * @param path the path of the file
+     * @param shape the shape of the array
+     * @param l the layout of the data in the file
+     * @param data_offset the position of the first element in the file, in bytes
+     */
+    template <class T>
+    inline xfile_array<T> open_raw_file(const std::string& path, const std::vector<std::size_t>& shape,
+                                        xt::layout l, std::size_t data_offset)
+    {
+        return xfile_array<T>(path, shape, l, data_offset);
+    }
+
+    /**
+     * @brief Opens a NPY file as an expression.
+     *
+     * Reads the header of the NPY file \c path and returns an xfile_array over
+     * its data. The type described in the header must match \c T.
+     * @param path the path of the file
+     */
+    template <class T>
+    inline xfile_array<T> open_npy_file(const std::string& path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        char magic[8] = {0};
+        in.read(magic, 8);
+        if (!in || std::string(magic, 6) != "\x93NUMPY")
+        {
+            throw std::runtime_error("Cannot read NPY file " + path);
+        }
+        std::size_t len_size = magic[6] == 1 ? 2 : 4;
+        unsigned char len_buf[4] = {0};
+        in.read(reinterpret_cast<char*>(len_buf), static_cast<std::streamsize>(len_size));
+        std::size_t header_len = 0;
+        for (std::size_t i = len_size; i != 0; --i)
+        {
+            header_len = (header_len << 8) | len_buf[i - 1];
+        }
+        std::string header(header_len, ' ');
+        in.read(&header[0], static_cast<std::streamsize>(header_len));
+        if (!in)
+        {
+            throw std::runtime_error("Invalid NPY header in " + path);
+        }
+
+        std::string descr = detail::npy_header_value(header, "descr");
+        descr = descr.substr(1, descr.size() - 2);
+        std::string expected = dtype_kind<T>() + std::to_string(sizeof(T));
+        if (descr.size() < 2 || descr.substr(1) != expected)
+        {
+            throw std::runtime_error("NPY type " + descr + " does not match " + expected);
+        }
+        bool swap = (descr[0] == '<' && !detail::is_little_endian()) ||
+            (descr[0] == '>' && detail::is_little_endian());
+        bool fortran_order = detail::npy_header_value(header, "fortran_order") == "True";
+        auto shape = detail::npy_parse_shape(detail::npy_header_value(header, "shape"));
+
+        xt::layout l = fortran_order ? xt::layout::column_major : xt::layout::row_major;
+        return xfile_array<T>(path, shape, l, 8 + len_size + header_len, swap);
+    }
+}
+
+#endif
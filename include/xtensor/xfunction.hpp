@@ -11,6 +11,7 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <functional>
 #include <iterator>
 #include <numeric>
 #include <tuple>
@@ -20,6 +21,7 @@
 #include "xexpression.hpp"
 #include "xiterator.hpp"
 #include "xlayout.hpp"
+#include "xstrides.hpp"
 #include "xutils.hpp"
 
 namespace xt
@@ -78,6 +80,42 @@ namespace xt
 
         template <class... Args>
         using common_value_type_t = typename common_value_type<Args...>::type;
+
+        /*************************
+         * is_structured_product *
+         *************************/
+
+        // A product is zero wherever one of its operands is structurally zero
+        template <class F, class... E>
+        struct is_structured_product : std::false_type
+        {
+        };
+
+        template <class T, class... E>
+        struct is_structured_product<std::multiplies<T>, E...> : or_<has_nonzero_columns<E>...>
+        {
+        };
+
+        template <class E, class S, class P>
+        inline auto restrict_nonzero_columns(const E& e, const S& shape, std::size_t row, P range)
+            -> std::enable_if_t<has_nonzero_columns<E>::value, P>
+        {
+            // Broadcast operands do not map rows one to one
+            if (e.dimension() == shape.size() && std::equal(shape.cbegin(), shape.cend(), e.shape().cbegin()))
+            {
+                auto r = e.nonzero_columns(row);
+                range.first = std::max(range.first, static_cast<typename P::first_type>(r.first));
+                range.second = std::min(range.second, static_cast<typename P::second_type>(r.second));
+            }
+            return range;
+        }
+
+        template <class E, class S, class P>
+        inline auto restrict_nonzero_columns(const E&, const S&, std::size_t, P range)
+            -> std::enable_if_t<!has_nonzero_columns<E>::value, P>
+        {
+            return range;
+        }
     }
 
     template <class F, class R, class... CT>
@@ -86,6 +124,15 @@ namespace xt
     template <class F, class R, class... CT>
     class xfunction_stepper;
 
+    template <class F, class R, class... CT>
+    class xfunction;
+
+    template <class F, class R, class... CT>
+    struct is_concurrently_readable<xfunction<F, R, CT...>>
+        : and_<is_concurrently_callable<std::decay_t<F>>, is_concurrently_readable<std::decay_t<CT>>...>
+    {
+    };
+
     /*************
      * xfunction *
      *************/
@@ -179,6 +226,9 @@ namespace xt
         template <class S>
         const_stepper stepper_end(const S& shape) const noexcept;
 
+        template <class FT = functor_type, class = std::enable_if_t<detail::is_structured_product<FT, std::decay_t<CT>...>::value>>
+        std::pair<size_type, size_type> nonzero_columns(size_type row) const;
+
     private:
 
         template <std::size_t... I>
@@ -640,6 +690,26 @@ namespace xt
         return const_iterator(this, f(std::get<I>(m_e))...);
     }
 
+    /**
+     * Returns the range of columns of the specified row out of which the
+     * product is structurally zero, i.e. the intersection of the ranges
+     * of its structured operands. Only defined for 2-D products with a
+     * structured operand.
+     * @param row the index of the row
+     */
+    template <class F, class R, class... CT>
+    template <class FT, class>
+    inline auto xfunction<F, R, CT...>::nonzero_columns(size_type row) const -> std::pair<size_type, size_type>
+    {
+        using range_type = std::pair<size_type, size_type>;
+        auto func = [this, row](range_type range, auto&& e) {
+            return detail::restrict_nonzero_columns(e, this->shape(), row, range);
+        };
+        range_type range = accumulate(func, range_type(0, shape()[1]), m_e);
+        range.second = std::max(range.first, range.second);
+        return range;
+    }
+
     template <class F, class R, class... CT>
     inline auto xfunction<F, R, CT...>::compute_dimension() const noexcept -> size_type
     {
@@ -18,12 +18,16 @@
 
 #include "xexpression.hpp"
 #include "xiterable.hpp"
+#include "xstorage.hpp"
 #include "xstrides.hpp"
 #include "xutils.hpp"
 
 namespace xt
 {
 
+    template <class D>
+    class xcontainer;
+
     /**************
      * xgenerator *
      **************/
@@ -31,6 +35,15 @@ namespace xt
     template <class F, class R, class S>
     class xgenerator;
 
+    namespace detail
+    {
+        // Functors receive the index owned by the stepper of the generator
+        // through a pair of iterators. Those that need to adapt it before
+        // forwarding it to another expression copy it into this buffer,
+        // which only allocates beyond 8 dimensions.
+        using index_buffer = svector<std::size_t, 8>;
+    }
+
     template <class C, class R, class S>
     struct xiterable_inner_types<xgenerator<C, R, S>>
     {
@@ -116,6 +129,13 @@ namespace xt
         template <class O>
         const_stepper stepper_end(const O& shape) const noexcept;
 
+        template <class E, class FT = functor_type>
+        auto assign_to(E& e) const -> decltype(std::declval<const FT&>().assign_to(e, std::declval<const inner_shape_type&>()), bool());
+
+        template <class FT = functor_type>
+        auto nonzero_columns(size_type row) const
+            -> decltype(std::declval<const FT&>().nonzero_columns(row, std::declval<const inner_shape_type&>()));
+
     private:
 
         functor_type m_f;
@@ -273,6 +293,88 @@ namespace xt
         return const_stepper(this, offset, true);
     }
 
+    /**
+     * Evaluates the generator into \c e when its functor provides a faster
+     * block-wise evaluation than the element-wise one.
+     * @param e the expression to assign
+     * @return false if the generator is not evaluated, in which case the caller
+     * must fall back to the stepper-based assignment
+     */
+    template <class F, class R, class S>
+    template <class E, class FT>
+    inline auto xgenerator<F, R, S>::assign_to(E& e) const
+        -> decltype(std::declval<const FT&>().assign_to(e, std::declval<const inner_shape_type&>()), bool())
+    {
+        return m_f.assign_to(e, m_shape);
+    }
+
+    /**
+     * Returns the range of columns of the specified row out of which the
+     * elements of the generator are structurally zero. Only defined for
+     * 2-D generators whose functor describes its zeros.
+     * @param row the index of the row
+     */
+    template <class F, class R, class S>
+    template <class FT>
+    inline auto xgenerator<F, R, S>::nonzero_columns(size_type row) const
+        -> decltype(std::declval<const FT&>().nonzero_columns(row, std::declval<const inner_shape_type&>()))
+    {
+        return m_f.nonzero_columns(row, m_shape);
+    }
+
+    namespace detail
+    {
+        template <class F, class = void>
+        struct is_cheap_functor : std::false_type
+        {
+        };
+
+        template <class F>
+        struct is_cheap_functor<F, std::enable_if_t<F::is_cheap>> : std::true_type
+        {
+        };
+    }
+
+    /**
+     * Generators are cheap when their functor declares a static
+     * \c is_cheap member set to true.
+     */
+    template <class F, class R, class S>
+    struct is_cheap_expression<xgenerator<F, R, S>> : detail::is_cheap_functor<F>
+    {
+    };
+
+    /**
+     * Cheap generators compute their elements in closed form and can
+     * therefore be read concurrently.
+     */
+    template <class F, class R, class S>
+    struct is_concurrently_readable<xgenerator<F, R, S>> : detail::is_cheap_functor<F>
+    {
+    };
+
+    namespace detail
+    {
+        // Returns the storage of e if e is a row-major container of the
+        // specified shape, so that its elements can be filled linearly,
+        // and nullptr otherwise.
+        template <class E, class S>
+        inline auto linear_storage(E& e, const S& shape)
+            -> std::enable_if_t<std::is_base_of<xcontainer<E>, E>::value, typename E::value_type*>
+        {
+            bool same_shape = e.dimension() == shape.size() &&
+                std::equal(shape.begin(), shape.end(), e.shape().begin());
+            return same_shape && e.layout() == xt::layout::row_major ? e.raw_data() : nullptr;
+        }
+
+        template <class E, class S>
+        inline auto linear_storage(E&, const S&)
+            -> std::enable_if_t<!std::is_base_of<xcontainer<E>, E>::value, typename E::value_type*>
+        {
+            return nullptr;
+        }
+    }
+
     namespace detail
     {
 #ifdef X_OLD_CLANG
@@ -14,11 +14,18 @@
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
+#include "xarray.hpp"
+#include "xcontainer.hpp"
+#include "xexecution.hpp"
 #include "xexpression.hpp"
 #include "xiterable.hpp"
+#include "xoperation.hpp"
+#include "xsemantic.hpp"
 #include "xstrides.hpp"
 #include "xutils.hpp"
+#include "xvectorize.hpp"
 
 namespace xt
 {
@@ -26,6 +33,15 @@ namespace xt
     template <class CT, class I>
     class xindexview;
 
+    namespace detail
+    {
+        // Selects the constructor of xindexview taking the linear offsets
+        // of the elements instead of their indices
+        struct index_offsets_tag
+        {
+        };
+    }
+
     template <class CT, class I>
     struct xcontainer_inner_types<xindexview<CT, I>>
     {
@@ -58,6 +74,12 @@ namespace xt
      * xindexview is not meant to be used directly, but only with the \ref index_view
      * and \ref filter helper functions.
      *
+     * When the underlying expression is a container or a view on a container,
+     * the indices are turned into linear offsets in its buffer once, at
+     * construction; accesses and assignments then read and write the buffer
+     * directly. The offsets are not updated if the container is reshaped or
+     * resized afterwards.
+     *
      * @tparam CT the closure type of the \ref xexpression type underlying this view
      * @tparam I the index array type of the view
      *
@@ -89,6 +111,7 @@ namespace xt
         using closure_type = const self_type;
 
         using indices_type = I;
+        using offsets_type = std::vector<size_type>;
 
         using stepper = typename iterable_base::stepper;
         using const_stepper = typename iterable_base::const_stepper;
@@ -104,9 +127,11 @@ namespace xt
 
         static constexpr xt::layout layout_type = xt::layout::dynamic;
         static constexpr bool contiguous_layout = false;
+        static constexpr bool has_offsets = has_strided_data<xexpression_type>::value;
 
         template <class I2>
-        xindexview(CT e, I2&& indices) noexcept;
+        xindexview(CT e, I2&& indices);
+        xindexview(CT e, offsets_type offsets, detail::index_offsets_tag);
 
         template <class E>
         self_type& operator=(const xexpression<E>& e);
@@ -143,6 +168,10 @@ namespace xt
         template <class O>
         bool is_trivial_broadcast(const O& /*strides*/) const noexcept;
 
+        template <class E, class X = xexpression_type>
+        auto assign_to(E& e) const
+            -> std::enable_if_t<std::is_base_of<xcontainer<E>, E>::value && has_strided_data<X>::value, bool>;
+
         template <class ST>
         stepper stepper_begin(const ST& shape);
         template <class ST>
@@ -156,10 +185,24 @@ namespace xt
     private:
 
         CT m_e;
-        const indices_type m_indices;
         const inner_shape_type m_shape;
+        const offsets_type m_offsets;
+        const bool m_sorted_offsets;
+        const indices_type m_indices;
+
+        template <class V>
+        static decltype(auto) access(V& v, size_type i, std::true_type);
+        template <class V>
+        static decltype(auto) access(V& v, size_type i, std::false_type);
+
+        template <class E>
+        void fill(const E& e, std::true_type);
+        template <class E>
+        void fill(const E& e, std::false_type);
 
         void assign_temporary_impl(temporary_type& tmp);
+        void assign_temporary_impl(temporary_type& tmp, std::true_type);
+        void assign_temporary_impl(temporary_type& tmp, std::false_type);
 
         friend class xview_semantic<xindexview<CT, I>>;
     };
@@ -222,6 +265,134 @@ namespace xt
         CCT m_condition;
     };
 
+    /******************
+     * gather/scatter *
+     ******************/
+
+    namespace detail
+    {
+        // Number of elements between the one being copied and the one
+        // prefetched when the offsets are not sorted
+        constexpr std::size_t index_prefetch_distance = 16;
+
+        template <class T>
+        inline void prefetch_read(const T* p) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(p, 0);
+#else
+            (void)p;
+#endif
+        }
+
+        template <class T>
+        inline void prefetch_write(const T* p) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(p, 1);
+#else
+            (void)p;
+#endif
+        }
+
+        // Linear offsets of the indices in the buffer of e
+        template <class O, class E, class I>
+        inline O make_index_offsets(const E& e, const I& indices, std::true_type)
+        {
+            using size_type = typename O::value_type;
+            O offsets;
+            offsets.reserve(indices.size());
+            const auto& strides = e.strides();
+            size_type base = e.raw_data_offset();
+            for (const auto& index : indices)
+            {
+                offsets.push_back(base + element_offset<size_type>(strides, index.cbegin(), index.cend()));
+            }
+            return offsets;
+        }
+
+        template <class O, class E, class I>
+        inline O make_index_offsets(const E&, const I&, std::false_type)
+        {
+            return O();
+        }
+
+        // The indices are only kept when they are not replaced by offsets
+        template <class I, class I2>
+        inline I store_indices(I2&&, std::true_type)
+        {
+            return I();
+        }
+
+        template <class I, class I2>
+        inline I store_indices(I2&& indices, std::false_type)
+        {
+            return I(std::forward<I2>(indices));
+        }
+
+        // dst[i] = src[offsets[i]] for i in [first, last)
+        template <class T, class U, class O>
+        inline void gather(T* dst, const U* src, const O* offsets, std::size_t first, std::size_t last, bool prefetch)
+        {
+            std::size_t i = first;
+            if (prefetch)
+            {
+                for (; i + index_prefetch_distance < last; ++i)
+                {
+                    prefetch_read(src + offsets[i + index_prefetch_distance]);
+                    dst[i] = static_cast<T>(src[offsets[i]]);
+                }
+            }
+            for (; i < last; ++i)
+            {
+                dst[i] = static_cast<T>(src[offsets[i]]);
+            }
+        }
+
+        // dst[offsets[i]] = src[i] for i in [0, size); with repeated
+        // offsets, the last write wins
+        template <class T, class U, class O>
+        inline void scatter(T* dst, const U* src, const O* offsets, std::size_t size, bool prefetch)
+        {
+            std::size_t i = 0;
+            if (prefetch)
+            {
+                for (; i + index_prefetch_distance < size; ++i)
+                {
+                    prefetch_write(dst + offsets[i + index_prefetch_distance]);
+                    dst[offsets[i]] = static_cast<T>(src[i]);
+                }
+            }
+            for (; i < size; ++i)
+            {
+                dst[offsets[i]] = static_cast<T>(src[i]);
+            }
+        }
+
+        template <class E, class C>
+        inline auto make_filter(E&& e, C&& condition, std::true_type)
+        {
+            using indices_type = decltype(where(condition));
+            using view_type = xindexview<xclosure_t<E>, indices_type>;
+            using offsets_type = typename view_type::offsets_type;
+            if (e.dimension() == condition.dimension() &&
+                std::equal(e.shape().cbegin(), e.shape().cend(), condition.shape().cbegin()))
+            {
+                auto offsets = nonzero_offsets<offsets_type>(condition, e.strides(), e.raw_data_offset());
+                return view_type(std::forward<E>(e), std::move(offsets), index_offsets_tag());
+            }
+            return view_type(std::forward<E>(e), where(condition));
+        }
+
+        template <class E, class C>
+        inline auto make_filter(E&& e, C&& condition, std::false_type)
+        {
+            auto indices = where(std::forward<C>(condition));
+            using view_type = xindexview<xclosure_t<E>, decltype(indices)>;
+            return view_type(std::forward<E>(e), std::move(indices));
+        }
+    }
+
     /*****************************
      * xindexview implementation *
      *****************************/
@@ -239,10 +410,30 @@ namespace xt
      */
     template <class CT, class I>
     template <class I2>
-    inline xindexview<CT, I>::xindexview(CT e, I2&& indices) noexcept
-        : m_e(e), m_indices(std::forward<I2>(indices)), m_shape({m_indices.size()})
+    inline xindexview<CT, I>::xindexview(CT e, I2&& indices)
+        : m_e(e), m_shape({indices.size()}),
+          m_offsets(detail::make_index_offsets<offsets_type>(m_e, indices, std::integral_constant<bool, has_offsets>())),
+          m_sorted_offsets(std::is_sorted(m_offsets.cbegin(), m_offsets.cend())),
+          m_indices(detail::store_indices<indices_type>(std::forward<I2>(indices), std::integral_constant<bool, has_offsets>()))
     {
     }
+
+    /**
+     * Constructs an xindexview selecting the elements at the specified linear
+     * offsets in the buffer of \a e. This constructor is only available when
+     * \a e is a container or a view on a container.
+     *
+     * @param e the underlying xexpression for this view
+     * @param offsets the offsets of the elements to select, including the
+     * offset of the data of \a e in its buffer
+     */
+    template <class CT, class I>
+    inline xindexview<CT, I>::xindexview(CT e, offsets_type offsets, detail::index_offsets_tag)
+        : m_e(e), m_shape({offsets.size()}), m_offsets(std::move(offsets)),
+          m_sorted_offsets(std::is_sorted(m_offsets.cbegin(), m_offsets.cend())), m_indices()
+    {
+        static_assert(has_offsets, "offsets require an expression with strided data");
+    }
     //@}
 
     /**
@@ -264,12 +455,42 @@ namespace xt
     template <class E>
     inline auto xindexview<CT, I>::operator=(const E& e) -> disable_xexpression<E, self_type>&
     {
-        std::fill(this->begin(), this->end(), e);
+        fill(e, std::integral_constant<bool, has_offsets>());
         return *this;
     }
 
+    template <class CT, class I>
+    template <class E>
+    inline void xindexview<CT, I>::fill(const E& e, std::true_type)
+    {
+        auto data = m_e.raw_data();
+        for (auto offset : m_offsets)
+        {
+            data[offset] = e;
+        }
+    }
+
+    template <class CT, class I>
+    template <class E>
+    inline void xindexview<CT, I>::fill(const E& e, std::false_type)
+    {
+        std::fill(this->begin(), this->end(), e);
+    }
+
     template <class CT, class I>
     inline void xindexview<CT, I>::assign_temporary_impl(temporary_type& tmp)
+    {
+        assign_temporary_impl(tmp, std::integral_constant<bool, has_offsets>());
+    }
+
+    template <class CT, class I>
+    inline void xindexview<CT, I>::assign_temporary_impl(temporary_type& tmp, std::true_type)
+    {
+        detail::scatter(m_e.raw_data(), tmp.raw_data(), m_offsets.data(), m_offsets.size(), !m_sorted_offsets);
+    }
+
+    template <class CT, class I>
+    inline void xindexview<CT, I>::assign_temporary_impl(temporary_type& tmp, std::false_type)
     {
         std::copy(tmp.cbegin(), tmp.cend(), this->xbegin());
     }
@@ -332,7 +553,7 @@ namespace xt
     template <class... Args>
     inline auto xindexview<CT, I>::operator()(std::size_t idx, Args... /*args*/) -> reference
     {
-        return m_e[m_indices[idx]];
+        return access(*this, idx, std::integral_constant<bool, has_offsets>());
     }
 
     /**
@@ -344,13 +565,13 @@ namespace xt
     template <class... Args>
     inline auto xindexview<CT, I>::operator()(std::size_t idx, Args... /*args*/) const -> const_reference
     {
-        return m_e[m_indices[idx]];
+        return access(*this, idx, std::integral_constant<bool, has_offsets>());
     }
 
     template <class CT, class I>
     inline auto xindexview<CT, I>::operator[](const xindex& index) -> reference
     {
-        return m_e[m_indices[index[0]]];
+        return operator()(index[0]);
     }
 
     template <class CT, class I>
@@ -362,7 +583,7 @@ namespace xt
     template <class CT, class I>
     inline auto xindexview<CT, I>::operator[](const xindex& index) const -> const_reference
     {
-        return m_e[m_indices[index[0]]];
+        return operator()(index[0]);
     }
 
     template <class CT, class I>
@@ -380,17 +601,31 @@ namespace xt
     template <class It>
     inline auto xindexview<CT, I>::element(It first, It /*last*/) -> reference
     {
-        return m_e[m_indices[(*first)]];
+        return operator()(*first);
     }
 
     template <class CT, class I>
     template <class It>
     inline auto xindexview<CT, I>::element(It first, It /*last*/) const -> const_reference
     {
-        return m_e[m_indices[(*first)]];
+        return operator()(*first);
     }
     //@}
 
+    template <class CT, class I>
+    template <class V>
+    inline decltype(auto) xindexview<CT, I>::access(V& v, size_type i, std::true_type)
+    {
+        return v.m_e.raw_data()[v.m_offsets[i]];
+    }
+
+    template <class CT, class I>
+    template <class V>
+    inline decltype(auto) xindexview<CT, I>::access(V& v, size_type i, std::false_type)
+    {
+        return v.m_e[v.m_indices[i]];
+    }
+
     /**
      * @name Broadcasting
      */
@@ -420,6 +655,42 @@ namespace xt
     }
     //@}
 
+    /**
+     * Gathers the selected elements into the 1-D container \c e, splitting
+     * the copy among threads when the parallel execution policy applies.
+     * This overload is only available when the underlying expression is
+     * a container or a view on a container.
+     * @param e the container to assign, whose shape must be the shape of the view
+     * @return false if the elements are not gathered, in which case the caller
+     * must fall back to the stepper-based assignment
+     */
+    template <class CT, class I>
+    template <class E, class X>
+    inline auto xindexview<CT, I>::assign_to(E& e) const
+        -> std::enable_if_t<std::is_base_of<xcontainer<E>, E>::value && has_strided_data<X>::value, bool>
+    {
+        if (e.dimension() != 1 || e.shape()[0] != size())
+        {
+            return false;
+        }
+        auto dst = e.raw_data() + e.raw_data_offset();
+        auto src = m_e.raw_data();
+        const size_type* offsets = m_offsets.data();
+        bool prefetch = !m_sorted_offsets;
+        if (detail::use_parallel(size()))
+        {
+            parallel_for(0, size(), execution_options::execution_options().grain_size,
+                         [dst, src, offsets, prefetch](std::size_t first, std::size_t last) {
+                             detail::gather(dst, src, offsets, first, last, prefetch);
+                         });
+        }
+        else
+        {
+            detail::gather(dst, src, offsets, 0, size(), prefetch);
+        }
+        return true;
+    }
+
     /***************
      * stepper api *
      ***************/
@@ -551,7 +822,9 @@ namespace xt
     template <class F>
     inline auto xfiltration<ECT, CCT>::apply(F&& func) -> self_type&
     {
-        std::transform(m_e.cbegin(), m_e.cend(), m_condition.cbegin(), m_e.begin(), func);
+        // Every element is blended with its update in a single assignment
+        // pass, which is split among threads like any other assignment
+        computed_assign(m_e, vectorize(std::forward<F>(func))(m_e, m_condition));
         return *this;
     }
 
@@ -572,14 +845,14 @@ namespace xt
      * \endcode
      */
     template <class E, class I>
-    inline auto index_view(E&& e, I&& indices) noexcept
+    inline auto index_view(E&& e, I&& indices)
     {
         using view_type = xindexview<xclosure_t<E>, std::decay_t<I>>;
         return view_type(std::forward<E>(e), std::forward<I>(indices));
     }
 #ifdef X_OLD_CLANG
     template <class E, class I>
-    inline auto index_view(E&& e, std::initializer_list<std::initializer_list<I>> indices) noexcept
+    inline auto index_view(E&& e, std::initializer_list<std::initializer_list<I>> indices)
     {
         std::vector<xindex> idx;
         for (auto it = indices.begin(); it != indices.end(); ++it)
@@ -591,7 +864,7 @@ namespace xt
     }
 #else
     template <class E, std::size_t L>
-    inline auto index_view(E&& e, const xindex (&indices)[L]) noexcept
+    inline auto index_view(E&& e, const xindex (&indices)[L])
     {
         using view_type = xindexview<xclosure_t<E>, std::array<xindex, L>>;
         return view_type(std::forward<E>(e), to_array(indices));
@@ -619,11 +892,10 @@ namespace xt
      * \sa filtration
      */
     template <class E, class O>
-    inline auto filter(E&& e, O&& condition) noexcept
+    inline auto filter(E&& e, O&& condition)
     {
-        auto indices = where(std::forward<O>(condition));
-        using view_type = xindexview<xclosure_t<E>, decltype(indices)>;
-        return view_type(std::forward<E>(e), std::move(indices));
+        return detail::make_filter(std::forward<E>(e), std::forward<O>(condition),
+                                   std::integral_constant<bool, has_strided_data<std::decay_t<E>>::value>());
     }
 
     /**
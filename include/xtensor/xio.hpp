@@ -100,126 +100,121 @@ namespace xt
 
     namespace detail
     {
-        template <std::size_t I>
-        struct xout
+        // Prints the subexpression of e whose leading indices are index, using
+        // the values cached by the printer; deeper levels than depth are elided.
+        template <class E, class F>
+        std::ostream& xout(std::ostream& out, const E& e, xindex& index, F& printer, std::size_t depth,
+                           std::size_t blanks, precision_type element_width, std::size_t edge_items,
+                           std::size_t line_width)
         {
-            template <class E, class F>
-            static std::ostream& output(std::ostream& out, const E& e, F& printer, std::size_t blanks,
-                                        precision_type element_width, std::size_t edge_items, std::size_t line_width)
-            {
-                using size_type = typename E::size_type;
+            using size_type = typename E::size_type;
 
-                if (e.dimension() == 0)
-                {
-                    printer.print_next(out);
-                }
-                else
-                {
-                    std::string indents(blanks, ' ');
+            size_type dim = e.dimension() - index.size();
+            if (dim == 0)
+            {
+                printer.print_next(out);
+            }
+            else if (depth == 0)
+            {
+                out << "{...}";
+            }
+            else
+            {
+                std::string indents(blanks, ' ');
 
-                    size_type i = 0;
-                    size_type elems_on_line = 0;
-                    size_type line_lim = (size_type)std::floor(line_width / (element_width + 2));
+                size_type n = e.shape()[index.size()];
+                size_type i = 0;
+                size_type elems_on_line = 0;
+                size_type line_lim = (size_type)std::floor(line_width / (element_width + 2));
 
-                    out << '{';
-                    for (; i != e.shape()[0] - 1; ++i)
+                index.push_back(0);
+                out << '{';
+                for (; i != n - 1; ++i)
+                {
+                    if (edge_items && n > (edge_items * 2) && i == edge_items)
                     {
-                        if (edge_items && e.shape()[0] > (edge_items * 2) && i == edge_items)
+                        out << "..., ";
+                        if (dim > 1)
                         {
-                            out << "..., ";
-                            if (e.dimension() > 1)
-                            {
-                                elems_on_line = 0;
-                                out << std::endl << indents;
-                            }
-                            i = e.shape()[0] - edge_items;
-                        }
-                        if (e.dimension() == 1 && line_lim != 0 && elems_on_line >= line_lim)
-                        {
-                            out << std::endl << indents;
                             elems_on_line = 0;
+                            out << std::endl << indents;
                         }
+                        i = n - edge_items;
+                    }
+                    if (dim == 1 && line_lim != 0 && elems_on_line >= line_lim)
+                    {
+                        out << std::endl << indents;
+                        elems_on_line = 0;
+                    }
 
-                        xout<I - 1>::output(out, view(e, i), printer, blanks + 1, element_width, edge_items, line_width) << ',';
+                    index.back() = i;
+                    xout(out, e, index, printer, depth - 1, blanks + 1, element_width, edge_items, line_width) << ',';
 
-                        elems_on_line++;
+                    elems_on_line++;
 
-                        if (I == 1 || e.dimension() == 1)
-                        {
-                            out << ' ';
-                        }
-                        else
-                        {
-                            out << std::endl << indents;
-                        }
+                    if (depth == 1 || dim == 1)
+                    {
+                        out << ' ';
                     }
-                    if (e.dimension() == 1 && line_lim != 0 && elems_on_line >= line_lim)
+                    else
                     {
                         out << std::endl << indents;
                     }
-                    xout<I - 1>::output(out, view(e, i), printer, blanks + 1, element_width, edge_items, line_width) << '}';
                 }
-                return out;
-            }
-        };
-
-        template <>
-        struct xout<0>
-        {
-            template <class E, class F>
-            static std::ostream& output(std::ostream& out, const E& e, F& printer,
-                                        std::size_t, precision_type, std::size_t, std::size_t)
-            {
-                if (e.dimension() == 0)
+                if (dim == 1 && line_lim != 0 && elems_on_line >= line_lim)
                 {
-                    return printer.print_next(out);
-                }
-                else
-                {
-                    return out << "{...}";
+                    out << std::endl << indents;
                 }
+                index.back() = i;
+                xout(out, e, index, printer, depth - 1, blanks + 1, element_width, edge_items, line_width) << '}';
+                index.pop_back();
             }
-        };
+            return out;
+        }
 
-        template <std::size_t I>
-        struct recurser
+        // Feeds the printer with the elements that will be printed, in traversal
+        // order: only the edge items of summarized dimensions are evaluated.
+        template <class F, class E>
+        void recurser_run(F& fn, const E& e, xindex& index, std::size_t depth, std::size_t lim)
         {
-            template <class F, class E>
-            static void run(F& fn, const E& e, std::size_t lim = 0)
+            using size_type = typename E::size_type;
+
+            if (index.size() == e.dimension())
             {
-                using size_type = typename E::size_type;
-                if (e.dimension() == 0)
-                {
-                    fn.update(e());
-                }
-                else
+                fn.update(e.element(index.cbegin(), index.cend()));
+            }
+            else if (depth != 0)
+            {
+                size_type n = e.shape()[index.size()];
+                index.push_back(0);
+                for (size_type i = 0; i < n; ++i)
                 {
-                    size_type i = 0;
-                    for (; i != e.shape()[0] - 1; ++i)
+                    if (lim && n > (lim * 2) && i == lim)
                     {
-                        if (lim && e.shape()[0] > (lim * 2) && i == lim)
-                        {
-                            i = e.shape()[0] - lim;
-                        }
-                        recurser<I - 1>::run(fn, view(e, i), lim);
+                        i = n - lim;
                     }
-                    recurser<I - 1>::run(fn, view(e, i), lim);
+                    index.back() = i;
+                    recurser_run(fn, e, index, depth - 1, lim);
                 }
+                index.pop_back();
             }
-        };
+        }
 
-        template <>
-        struct recurser<0>
+        // Number of elements visited by recurser_run
+        template <class S>
+        inline std::size_t printed_size(const S& shape, std::size_t depth, std::size_t lim)
         {
-            template <class F, class E>
-            static void run(F& fn, const E& e, std::size_t)
+            if (shape.size() > depth)
             {
-                if (e.dimension() == 0)
-                {
-                    fn.update(e());
-                }
+                return 0;
             }
-        };
+            std::size_t size = 1;
+            for (auto s : shape)
+            {
+                size *= (lim && s > lim * 2) ? lim * 2 : s;
+            }
+            return size;
+        }
 
         template <class T, class E = void>
         struct printer;
@@ -309,6 +304,11 @@ namespace xt
                 return out;
             }
 
+            void reserve(std::size_t n)
+            {
+                m_cache.reserve(n);
+            }
+
             void update(const value_type& val)
             {
                 if (val != 0 && !std::isinf(val) && !std::isnan(val))
@@ -385,6 +385,11 @@ namespace xt
                 return out;
             }
 
+            void reserve(std::size_t n)
+            {
+                m_cache.reserve(n);
+            }
+
             void update(const value_type& val)
             {
                 if (std::abs(val) > m_max)
@@ -445,6 +450,11 @@ namespace xt
                 return out;
             }
 
+            void reserve(std::size_t n)
+            {
+                m_cache.reserve(n);
+            }
+
             void update(const value_type& val)
             {
                 m_cache.push_back(val);
@@ -508,6 +518,13 @@ namespace xt
                 return out;
             }
 
+            void reserve(std::size_t n)
+            {
+                real_printer.reserve(n);
+                imag_printer.reserve(n);
+                m_signs.reserve(n);
+            }
+
             void update(const value_type& val)
             {
                 real_printer.update(val.real());
@@ -554,6 +571,11 @@ namespace xt
                 return out;
             }
 
+            void reserve(std::size_t n)
+            {
+                m_cache.reserve(n);
+            }
+
             void update(const value_type& val)
             {
                 std::stringstream buf;
@@ -644,9 +666,12 @@ namespace xt
         detail::printer<E> p(precision);
 
         constexpr std::size_t depth = detail::recursion_depth<typename E::shape_type>::value;
-        detail::recurser<depth>::run(p, d, lim);
+        xindex index;
+        index.reserve(d.dimension());
+        p.reserve(detail::printed_size(d.shape(), depth, lim));
+        detail::recurser_run(p, d, index, depth, lim);
         p.init();
-        detail::xout<depth>::output(out, d, p, 1, p.width(), lim, print_options::print_options().line_width);
+        detail::xout(out, d, index, p, depth, 1, p.width(), lim, print_options::print_options().line_width);
 
         out << std::setprecision(temp_precision);  // restore precision
 
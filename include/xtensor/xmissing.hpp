@@ -107,6 +107,12 @@ namespace xt
         const_reverse_iterator crbegin() const;
         const_reverse_iterator crend() const;
 
+        base_container_type& value() noexcept;
+        const base_container_type& value() const noexcept;
+
+        flag_container_type& has_value() noexcept;
+        const flag_container_type& has_value() const noexcept;
+
     protected:
         base_container_type m_values;
         flag_container_type m_flags;
@@ -282,6 +288,30 @@ namespace xt
         return m_values.size();
     }
 
+    template <class D>
+    auto xoptional_sequence<D>::value() noexcept -> base_container_type&
+    {
+        return m_values;
+    }
+
+    template <class D>
+    auto xoptional_sequence<D>::value() const noexcept -> const base_container_type&
+    {
+        return m_values;
+    }
+
+    template <class D>
+    auto xoptional_sequence<D>::has_value() noexcept -> flag_container_type&
+    {
+        return m_flags;
+    }
+
+    template <class D>
+    auto xoptional_sequence<D>::has_value() const noexcept -> const flag_container_type&
+    {
+        return m_flags;
+    }
+
     template <class D>
     auto xoptional_sequence<D>::operator[](size_type i) -> reference
     {
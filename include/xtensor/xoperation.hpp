@@ -10,9 +10,14 @@
 #define XOPERATION_HPP
 
 #include <algorithm>
+#include <atomic>
+#include <cstddef>
 #include <functional>
+#include <numeric>
 #include <type_traits>
+#include <vector>
 
+#include "xexecution.hpp"
 #include "xfunction.hpp"
 #include "xscalar.hpp"
 #include "xstrides.hpp"
@@ -20,6 +25,9 @@
 namespace xt
 {
 
+    template <class D>
+    class xcontainer;
+
     namespace detail
     {
 
@@ -71,6 +79,28 @@ namespace xt
             }
         };
 
+        template <class T>
+        struct truthy
+        {
+            using result_type = bool;
+
+            constexpr result_type operator()(const T& t) const noexcept
+            {
+                return static_cast<bool>(t);
+            }
+        };
+
+        template <class T>
+        struct nonzero_count
+        {
+            using result_type = std::size_t;
+
+            constexpr result_type operator()(const T& t) const noexcept
+            {
+                return static_cast<bool>(t) ? 1 : 0;
+            }
+        };
+
         template <template <class...> class F, class... E>
         inline auto make_xfunction(E&&... e) noexcept
         {
@@ -542,50 +572,218 @@ namespace xt
     }
 #endif
 
-    /**
-     * @ingroup logical_operators
-     * @brief return vector of indices where T is not zero
-     * 
-     * @param arr input array
-     * @return vector of \a index_types where arr is not equal to zero
-     */
-    template <class T>
-    inline auto nonzero(const T& arr)
-        -> std::vector<xindex_type_t<typename T::shape_type>>
+    /*********************
+     * stream compaction *
+     *********************/
+
+    namespace detail
     {
-        auto shape = arr.shape();
-        using index_type = xindex_type_t<typename T::shape_type>;
-        using size_type = typename T::size_type;
+        // Row-major buffer the conditions are evaluated to before being
+        // compacted
+        template <class T>
+        struct nonzero_mask
+        {
+            using type = xarray<bool, layout::row_major>;
+        };
 
-        index_type idx(arr.dimension(), 0);
-        std::vector<index_type> indices;
+        template <class T>
+        using nonzero_mask_t = typename nonzero_mask<T>::type;
 
-        auto next_idx = [&shape](index_type& idx)
+        // Writes to out the offsets of the elements of [first, last) whose
+        // mask is nonzero, the elements being numbered in row-major order
+        // over shape and addressed with strides from base
+        template <class O, class M, class S, class ST>
+        inline O* compact_mask(const M* mask, std::size_t first, std::size_t last,
+                               const S& shape, const ST& strides, O base, bool contiguous, O* out)
         {
-            for (int i = int(shape.size() - 1); i >= 0; --i)
+            if (contiguous)
+            {
+                for (std::size_t i = first; i < last; ++i)
+                {
+                    if (mask[i])
+                    {
+                        *out++ = base + static_cast<O>(i);
+                    }
+                }
+                return out;
+            }
+            std::size_t dim = shape.size();
+            std::vector<std::size_t> index(dim);
+            std::ptrdiff_t offset = static_cast<std::ptrdiff_t>(base);
+            std::size_t linear = first;
+            for (std::size_t d = dim; d != 0; --d)
             {
-                if (idx[i] >= shape[i] - 1)
+                index[d - 1] = linear % shape[d - 1];
+                linear /= shape[d - 1];
+                offset += static_cast<std::ptrdiff_t>(index[d - 1]) * static_cast<std::ptrdiff_t>(strides[d - 1]);
+            }
+            for (std::size_t i = first; i < last; ++i)
+            {
+                if (mask[i])
                 {
-                    idx[i] = 0;
+                    *out++ = static_cast<O>(offset);
                 }
-                else
+                for (std::size_t d = dim; d != 0; --d)
                 {
-                    idx[i]++;
-                    return idx;
+                    std::ptrdiff_t stride = static_cast<std::ptrdiff_t>(strides[d - 1]);
+                    if (++index[d - 1] != shape[d - 1])
+                    {
+                        offset += stride;
+                        break;
+                    }
+                    index[d - 1] = 0;
+                    offset -= static_cast<std::ptrdiff_t>(shape[d - 1] - 1) * stride;
                 }
             }
-            // return empty index, happens at last iteration step, but remains unused
-            return index_type();
-        };
+            return out;
+        }
+
+        // Offsets of the nonzero elements of the mask. The mask is split in
+        // blocks that are counted, then compacted at the position given by
+        // the prefix sum of the counts, so that the result is allocated once.
+        template <class O, class M, class S, class ST>
+        inline O make_mask_offsets(const M* mask, const S& shape, const ST& strides, typename O::value_type base)
+        {
+            using size_type = typename O::value_type;
+            bool contiguous = has_row_major_strides(shape, strides);
+            std::size_t size = compute_size(shape);
+            auto count_block = [mask](std::size_t first, std::size_t last) {
+                return static_cast<std::size_t>(std::count_if(mask + first, mask + last, [](const M& m) { return bool(m); }));
+            };
+            O offsets;
+            if (!use_parallel(size))
+            {
+                offsets.resize(count_block(0, size));
+                compact_mask(mask, 0, size, shape, strides, base, contiguous, offsets.data());
+                return offsets;
+            }
+            std::size_t block_size = std::max(std::size_t(1), execution_options::execution_options().grain_size);
+            std::size_t nb_blocks = (size + block_size - 1) / block_size;
+            std::vector<std::size_t> counts(nb_blocks + 1, 0);
+            parallel_for(0, nb_blocks, 1, [&](std::size_t first, std::size_t last) {
+                for (std::size_t b = first; b != last; ++b)
+                {
+                    counts[b + 1] = count_block(b * block_size, std::min(size, (b + 1) * block_size));
+                }
+            });
+            std::partial_sum(counts.cbegin(), counts.cend(), counts.begin());
+            offsets.resize(counts.back());
+            size_type* out = offsets.data();
+            parallel_for(0, nb_blocks, 1, [&](std::size_t first, std::size_t last) {
+                for (std::size_t b = first; b != last; ++b)
+                {
+                    compact_mask(mask, b * block_size, std::min(size, (b + 1) * block_size),
+                                 shape, strides, base, contiguous, out + counts[b]);
+                }
+            });
+            return offsets;
+        }
+
+        // Containers are compacted in place when they are row-major, other
+        // conditions are evaluated first
+        template <class C>
+        inline auto row_major_mask(const C& condition)
+            -> std::enable_if_t<std::is_base_of<xcontainer<C>, C>::value, const C&>
+        {
+            return condition;
+        }
+
+        template <class C>
+        inline auto row_major_mask(const C& condition)
+            -> std::enable_if_t<!std::is_base_of<xcontainer<C>, C>::value, nonzero_mask_t<C>>
+        {
+            return nonzero_mask_t<C>(condition);
+        }
+
+        template <class C>
+        inline auto row_major_mask_data(const C& mask) -> const typename C::value_type*
+        {
+            return has_row_major_strides(mask.shape(), mask.strides()) ? mask.raw_data() + mask.raw_data_offset() : nullptr;
+        }
+
+        // Offsets, in a buffer addressed with strides from base, of the
+        // nonzero elements of condition
+        template <class O, class C, class ST>
+        inline O nonzero_offsets(const C& condition, const ST& strides, typename O::value_type base)
+        {
+            const auto& mask = row_major_mask(condition);
+            const auto* data = row_major_mask_data(mask);
+            if (data != nullptr)
+            {
+                return make_mask_offsets<O>(data, condition.shape(), strides, base);
+            }
+            nonzero_mask_t<C> row_mask = mask;
+            return make_mask_offsets<O>(row_mask.raw_data(), condition.shape(), strides, base);
+        }
 
-        size_type total_size = compute_size(shape);
-        for (size_type i = 0; i < total_size; i++, next_idx(idx))
+        // Calls f(i, index) with the row-major multi-index of every linear
+        // position of positions, in parallel for large outputs
+        template <class S, class P, class F>
+        inline void unravel_positions(const S& shape, const P& positions, F&& f)
         {
-            if (arr[idx])
+            std::size_t dim = shape.size();
+            auto unravel = [&shape, &positions, &f, dim](std::size_t first, std::size_t last) {
+                std::vector<std::size_t> index(dim);
+                for (std::size_t i = first; i < last; ++i)
+                {
+                    std::size_t linear = positions[i];
+                    for (std::size_t d = dim; d != 0; --d)
+                    {
+                        index[d - 1] = linear % shape[d - 1];
+                        linear /= shape[d - 1];
+                    }
+                    f(i, index);
+                }
+            };
+            if (use_parallel(positions.size() * std::max(dim, std::size_t(1))))
+            {
+                parallel_for(0, positions.size(), execution_options::execution_options().grain_size, unravel);
+            }
+            else
             {
-                indices.push_back(idx);
+                unravel(0, positions.size());
             }
         }
+    }
+
+    /**
+     * @ingroup logical_operators
+     * @brief return the linear indices of the nonzero elements of arr
+     *
+     * The indices are positions in the row-major order of the elements
+     * of \a arr. They are computed in a counting pass followed by a
+     * compaction pass, both split among threads for large inputs.
+     *
+     * @param arr input array
+     * @return vector of the row-major positions where arr is not equal to zero
+     */
+    template <class T>
+    inline auto flatnonzero(const T& arr)
+        -> std::vector<typename T::size_type>
+    {
+        using size_type = typename T::size_type;
+        auto strides = arr.shape();
+        compute_strides(arr.shape(), layout::row_major, strides);
+        return detail::nonzero_offsets<std::vector<size_type>>(arr, strides, size_type(0));
+    }
+
+    /**
+     * @ingroup logical_operators
+     * @brief return vector of indices where T is not zero
+     * 
+     * @param arr input array
+     * @return vector of \a index_types where arr is not equal to zero
+     */
+    template <class T>
+    inline auto nonzero(const T& arr)
+        -> std::vector<xindex_type_t<typename T::shape_type>>
+    {
+        using index_type = xindex_type_t<typename T::shape_type>;
+        auto positions = flatnonzero(arr);
+        std::vector<index_type> indices(positions.size(), index_type(arr.dimension(), 0));
+        detail::unravel_positions(arr.shape(), positions, [&indices](std::size_t i, const auto& index) {
+            std::copy(index.cbegin(), index.cend(), indices[i].begin());
+        });
         return indices;
     }
 
@@ -604,37 +802,282 @@ namespace xt
         return nonzero(condition);
     }
 
+    /**
+     * @ingroup logical_operators
+     * @brief return the indices of the nonzero elements of arr in a single tensor
+     *
+     * The k-th row of the result holds the index of the k-th nonzero element
+     * of \a arr in row-major order. Unlike \ref nonzero, the result is
+     * allocated once.
+     *
+     * @param arr input array
+     * @return tensor of shape (count, dimension of arr)
+     */
+    template <class T>
+    inline auto argwhere(const T& arr)
+        -> xtensor<typename T::size_type, 2>
+    {
+        using size_type = typename T::size_type;
+        auto positions = flatnonzero(arr);
+        size_type dim = arr.dimension();
+        xtensor<size_type, 2> indices({positions.size(), dim});
+        size_type* data = indices.raw_data();
+        detail::unravel_positions(arr.shape(), positions, [data, dim](std::size_t i, const auto& index) {
+            std::copy(index.cbegin(), index.cend(), data + i * dim);
+        });
+        return indices;
+    }
+
+    /******************
+     * any, all, count *
+     ******************/
+
+    namespace detail
+    {
+        // Number of elements evaluated between two checks of the early exit
+        // condition of any and all; the elements of a block are tested
+        // without branching so that the loop can be vectorized
+        constexpr std::size_t logical_block_size = 1024;
+
+        template <class It, class P>
+        inline bool any_of_blocks(It first, std::size_t size, P pred)
+        {
+            while (size != 0)
+            {
+                std::size_t n = std::min(size, logical_block_size);
+                bool found = false;
+                for (std::size_t i = 0; i < n; ++i, ++first)
+                {
+                    found |= pred(*first);
+                }
+                if (found)
+                {
+                    return true;
+                }
+                size -= n;
+            }
+            return false;
+        }
+
+        // The buffer of a container is split among threads, which stop as
+        // soon as one of them finds a decisive block
+        template <class T, class P>
+        inline bool any_of_buffer(const T* data, std::size_t size, P pred)
+        {
+            if (!use_parallel(size))
+            {
+                return any_of_blocks(data, size, pred);
+            }
+            std::atomic<bool> found(false);
+            std::size_t grain = std::max(execution_options::execution_options().grain_size, logical_block_size);
+            parallel_for(0, size, grain, [data, pred, &found](std::size_t first, std::size_t last) {
+                for (std::size_t b = first; b < last && !found.load(std::memory_order_relaxed); b += logical_block_size)
+                {
+                    if (any_of_blocks(data + b, std::min(logical_block_size, last - b), pred))
+                    {
+                        found.store(true, std::memory_order_relaxed);
+                    }
+                }
+            });
+            return found.load();
+        }
+
+        template <class E, class P>
+        inline auto any_of(const E& e, P pred)
+            -> std::enable_if_t<std::is_base_of<xcontainer<E>, E>::value, bool>
+        {
+            return any_of_buffer(e.raw_data() + e.raw_data_offset(), e.size(), pred);
+        }
+
+        template <class E, class P>
+        inline auto any_of(const E& e, P pred)
+            -> std::enable_if_t<!std::is_base_of<xcontainer<E>, E>::value, bool>
+        {
+            return any_of_blocks(e.cbegin(), e.size(), pred);
+        }
+
+        template <class T>
+        inline std::size_t count_nonzero_buffer(const T* data, std::size_t size)
+        {
+            auto count = [data](std::size_t first, std::size_t last) {
+                std::size_t res = 0;
+                for (std::size_t i = first; i < last; ++i)
+                {
+                    res += static_cast<bool>(data[i]) ? 1 : 0;
+                }
+                return res;
+            };
+            if (!use_parallel(size))
+            {
+                return count(0, size);
+            }
+            std::size_t block_size = std::max(std::size_t(1), execution_options::execution_options().grain_size);
+            std::size_t nb_blocks = (size + block_size - 1) / block_size;
+            std::vector<std::size_t> counts(nb_blocks, 0);
+            parallel_for(0, nb_blocks, 1, [&](std::size_t first, std::size_t last) {
+                for (std::size_t b = first; b != last; ++b)
+                {
+                    counts[b] = count(b * block_size, std::min(size, (b + 1) * block_size));
+                }
+            });
+            return std::accumulate(counts.cbegin(), counts.cend(), std::size_t(0));
+        }
+
+        template <class E>
+        inline auto count_nonzero(const E& e)
+            -> std::enable_if_t<std::is_base_of<xcontainer<E>, E>::value, std::size_t>
+        {
+            return count_nonzero_buffer(e.raw_data() + e.raw_data_offset(), e.size());
+        }
+
+        template <class E>
+        inline auto count_nonzero(const E& e)
+            -> std::enable_if_t<!std::is_base_of<xcontainer<E>, E>::value, std::size_t>
+        {
+            using value_type = typename E::value_type;
+            return static_cast<std::size_t>(std::count_if(e.cbegin(), e.cend(), [](const value_type& el) { return static_cast<bool>(el); }));
+        }
+    }
+
     /**
     * @ingroup logical_operators
     * @brief Any
     *
     * Returns true if any of the values of \a e is truthy,
-    * false otherwise.
+    * false otherwise. The values are tested by blocks and the
+    * evaluation stops after the first block holding a truthy value.
     * @param e an \ref xexpression
     * @return a boolean
     */
     template <class E>
     inline bool any(E&& e)
     {
-        return std::any_of(e.cbegin(), e.cend(),
-                           [](const typename std::decay_t<E>::value_type& el) { return el; });
+        using value_type = typename std::decay_t<E>::value_type;
+        return detail::any_of(e, [](const value_type& el) { return static_cast<bool>(el); });
     }
 
     /**
     * @ingroup logical_operators
-    * @brief Any
+    * @brief Any along given axes.
+    *
+    * Returns an \ref xreducer telling whether any of the values
+    * of \a e is truthy over the given \em axes.
+    * @param e an \ref xexpression
+    * @param axes the axes along which the values are tested
+    * @return an \ref xreducer
+    */
+    template <class E, class X>
+    inline auto any(E&& e, X&& axes) noexcept
+    {
+        return reduce(std::logical_or<bool>(), detail::make_xfunction<detail::truthy>(std::forward<E>(e)), std::forward<X>(axes));
+    }
+
+#ifdef X_OLD_CLANG
+    template <class E, class I>
+    inline auto any(E&& e, std::initializer_list<I> axes) noexcept
+    {
+        return reduce(std::logical_or<bool>(), detail::make_xfunction<detail::truthy>(std::forward<E>(e)), axes);
+    }
+#else
+    template <class E, class I, std::size_t N>
+    inline auto any(E&& e, const I (&axes)[N]) noexcept
+    {
+        return reduce(std::logical_or<bool>(), detail::make_xfunction<detail::truthy>(std::forward<E>(e)), axes);
+    }
+#endif
+
+    /**
+    * @ingroup logical_operators
+    * @brief All
     *
     * Returns true if all of the values of \a e are truthy,
-    * false otherwise.
+    * false otherwise. The values are tested by blocks and the
+    * evaluation stops after the first block holding a falsy value.
     * @param e an \ref xexpression
     * @return a boolean
     */
     template <class E>
     inline bool all(E&& e)
     {
-        return std::all_of(e.cbegin(), e.cend(),
-                           [](const typename std::decay_t<E>::value_type& el) { return el; });
+        using value_type = typename std::decay_t<E>::value_type;
+        return !detail::any_of(e, [](const value_type& el) { return !static_cast<bool>(el); });
     }
+
+    /**
+    * @ingroup logical_operators
+    * @brief All along given axes.
+    *
+    * Returns an \ref xreducer telling whether all of the values
+    * of \a e are truthy over the given \em axes.
+    * @param e an \ref xexpression
+    * @param axes the axes along which the values are tested
+    * @return an \ref xreducer
+    */
+    template <class E, class X>
+    inline auto all(E&& e, X&& axes) noexcept
+    {
+        return reduce(std::logical_and<bool>(), detail::make_xfunction<detail::truthy>(std::forward<E>(e)), std::forward<X>(axes));
+    }
+
+#ifdef X_OLD_CLANG
+    template <class E, class I>
+    inline auto all(E&& e, std::initializer_list<I> axes) noexcept
+    {
+        return reduce(std::logical_and<bool>(), detail::make_xfunction<detail::truthy>(std::forward<E>(e)), axes);
+    }
+#else
+    template <class E, class I, std::size_t N>
+    inline auto all(E&& e, const I (&axes)[N]) noexcept
+    {
+        return reduce(std::logical_and<bool>(), detail::make_xfunction<detail::truthy>(std::forward<E>(e)), axes);
+    }
+#endif
+
+    /**
+    * @ingroup logical_operators
+    * @brief Number of nonzero values.
+    *
+    * Returns the number of truthy values of \a e. The buffer of
+    * containers is counted by blocks, split among threads for large
+    * containers.
+    * @param e an \ref xexpression
+    * @return the number of nonzero values
+    */
+    template <class E>
+    inline std::size_t count_nonzero(E&& e)
+    {
+        return detail::count_nonzero(e);
+    }
+
+    /**
+    * @ingroup logical_operators
+    * @brief Number of nonzero values along given axes.
+    *
+    * Returns an \ref xreducer for the number of truthy values
+    * of \a e over the given \em axes.
+    * @param e an \ref xexpression
+    * @param axes the axes along which the values are counted
+    * @return an \ref xreducer
+    */
+    template <class E, class X>
+    inline auto count_nonzero(E&& e, X&& axes) noexcept
+    {
+        return reduce(std::plus<std::size_t>(), detail::make_xfunction<detail::nonzero_count>(std::forward<E>(e)), std::forward<X>(axes));
+    }
+
+#ifdef X_OLD_CLANG
+    template <class E, class I>
+    inline auto count_nonzero(E&& e, std::initializer_list<I> axes) noexcept
+    {
+        return reduce(std::plus<std::size_t>(), detail::make_xfunction<detail::nonzero_count>(std::forward<E>(e)), axes);
+    }
+#else
+    template <class E, class I, std::size_t N>
+    inline auto count_nonzero(E&& e, const I (&axes)[N]) noexcept
+    {
+        return reduce(std::plus<std::size_t>(), detail::make_xfunction<detail::nonzero_count>(std::forward<E>(e)), axes);
+    }
+#endif
 }
 
 #endif
@@ -0,0 +1,512 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XPREFETCH_HPP
+#define XPREFETCH_HPP
+
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "xfile_array.hpp"
+#include "xserialize.hpp"
+#include "xtensor.hpp"
+
+namespace xt
+{
+
+    namespace detail
+    {
+        template <class T, std::size_t N>
+        class prefetch_state;
+    }
+
+    template <class T, std::size_t N>
+    class xprefetch_iterator;
+
+    /********************
+     * xprefetch_reader *
+     ********************/
+
+    /**
+     * @class xprefetch_reader
+     * @brief Chunked reader overlapping disk reads with computation.
+     *
+     * The xprefetch_reader class reads a row-major array stored in a file in
+     * chunks of consecutive rows (along the first axis). A background thread
+     * reads the next chunks into spare buffers while the current one is
+     * processed: with two buffers, one chunk is read while the previous one is
+     * evaluated; a third buffer absorbs irregular read or compute times.
+     *
+     * The ready chunks are visited through an input iterator; the chunk
+     * referenced by an iterator is released to the reading thread when the
+     * iterator is incremented, so that it must not be used afterwards.
+     *
+     * @tparam T the trivially copyable value type of the file
+     * @tparam N the number of dimensions of the array
+     * @sa make_prefetch_reader
+     */
+    template <class T, std::size_t N>
+    class xprefetch_reader
+    {
+
+    public:
+
+        using self_type = xprefetch_reader<T, N>;
+        using chunk_type = xtensor<T, N>;
+        using shape_type = std::array<std::size_t, N>;
+        using size_type = std::size_t;
+        using iterator = xprefetch_iterator<T, N>;
+        using const_iterator = iterator;
+
+        xprefetch_reader(const std::string& path, const shape_type& shape, size_type chunk_rows,
+                         size_type nb_buffers = 2, size_type data_offset = 0, bool swap_bytes = false);
+        ~xprefetch_reader();
+
+        xprefetch_reader(const xprefetch_reader&) = delete;
+        xprefetch_reader& operator=(const xprefetch_reader&) = delete;
+
+        xprefetch_reader(xprefetch_reader&&) = default;
+        xprefetch_reader& operator=(xprefetch_reader&&);
+
+        const shape_type& shape() const noexcept;
+        size_type chunk_rows() const noexcept;
+        size_type nb_chunks() const noexcept;
+        size_type nb_buffers() const noexcept;
+
+        iterator begin();
+        iterator end();
+
+    private:
+
+        using state_type = detail::prefetch_state<T, N>;
+
+        void stop();
+
+        std::unique_ptr<state_type> p_state;
+        std::thread m_thread;
+
+        friend class xprefetch_iterator<T, N>;
+    };
+
+    template <std::size_t N, class T>
+    xprefetch_reader<T, N> make_prefetch_reader(const xfile_array<T>& a, std::size_t chunk_rows,
+                                                std::size_t nb_buffers = 2);
+
+    /**********************
+     * xprefetch_iterator *
+     **********************/
+
+    template <class T, std::size_t N>
+    class xprefetch_iterator
+    {
+
+    public:
+
+        using self_type = xprefetch_iterator<T, N>;
+        using reader_type = xprefetch_reader<T, N>;
+        using value_type = typename reader_type::chunk_type;
+        using reference = const value_type&;
+        using pointer = const value_type*;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::input_iterator_tag;
+        using size_type = std::size_t;
+
+        xprefetch_iterator(reader_type* reader, size_type index) noexcept;
+
+        reference operator*() const;
+        pointer operator->() const;
+
+        self_type& operator++();
+
+        bool equal(const self_type& rhs) const noexcept;
+
+    private:
+
+        reader_type* p_reader;
+        size_type m_index;
+    };
+
+    template <class T, std::size_t N>
+    bool operator==(const xprefetch_iterator<T, N>& lhs, const xprefetch_iterator<T, N>& rhs) noexcept;
+
+    template <class T, std::size_t N>
+    bool operator!=(const xprefetch_iterator<T, N>& lhs, const xprefetch_iterator<T, N>& rhs) noexcept;
+
+    /*********************************
+     * prefetch_state implementation *
+     *********************************/
+
+    namespace detail
+    {
+        template <class T, std::size_t N>
+        class prefetch_state
+        {
+
+        public:
+
+            using chunk_type = xtensor<T, N>;
+            using shape_type = std::array<std::size_t, N>;
+            using size_type = std::size_t;
+
+            prefetch_state(const std::string& path, const shape_type& shape, size_type chunk_rows,
+                           size_type nb_buffers, size_type data_offset, bool swap_bytes);
+
+            void run();
+            void stop();
+
+            size_type nb_buffers() const noexcept;
+
+            const chunk_type& acquire(size_type index);
+            void release(size_type index);
+
+            std::string m_path;
+            shape_type m_shape;
+            size_type m_chunk_rows;
+            size_type m_row_size;
+            size_type m_nb_chunks;
+            size_type m_data_offset;
+            bool m_swap_bytes;
+
+        private:
+
+            struct slot
+            {
+                chunk_type m_data;
+                bool m_ready = false;
+            };
+
+            void read_chunk(std::ifstream& in, size_type index, chunk_type& chunk) const;
+
+            std::vector<slot> m_slots;
+            std::mutex m_mutex;
+            std::condition_variable m_cv;
+            std::exception_ptr m_error;
+            bool m_stop;
+        };
+
+        template <class T, std::size_t N>
+        inline prefetch_state<T, N>::prefetch_state(const std::string& path, const shape_type& shape,
+                                                    size_type chunk_rows, size_type nb_buffers,
+                                                    size_type data_offset, bool swap_bytes)
+            : m_path(path), m_shape(shape), m_chunk_rows(std::max(chunk_rows, size_type(1))),
+              m_row_size(N == 0 ? 1 : compute_size(shape) / std::max(shape[0], size_type(1))),
+              m_nb_chunks(N == 0 ? 1 : (shape[0] + m_chunk_rows - 1) / m_chunk_rows),
+              m_data_offset(data_offset), m_swap_bytes(swap_bytes),
+              m_slots(std::max(nb_buffers, size_type(2))), m_stop(false)
+        {
+        }
+
+        template <class T, std::size_t N>
+        inline void prefetch_state<T, N>::run()
+        {
+            try
+            {
+                std::ifstream in(m_path, std::ios::binary);
+                if (!in)
+                {
+                    throw std::runtime_error("Cannot open file " + m_path);
+                }
+                for (size_type index = 0; index < m_nb_chunks; ++index)
+                {
+                    slot& s = m_slots[index % m_slots.size()];
+                    {
+                        std::unique_lock<std::mutex> lock(m_mutex);
+                        m_cv.wait(lock, [this, &s]() { return m_stop || !s.m_ready; });
+                        if (m_stop)
+                        {
+                            return;
+                        }
+                    }
+                    // The slot is not visible to the consumer until it is ready
+                    read_chunk(in, index, s.m_data);
+                    {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        s.m_ready = true;
+                    }
+                    m_cv.notify_all();
+                }
+            }
+            catch (...)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_error = std::current_exception();
+                }
+                m_cv.notify_all();
+            }
+        }
+
+        template <class T, std::size_t N>
+        inline void prefetch_state<T, N>::stop()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+            }
+            m_cv.notify_all();
+        }
+
+        template <class T, std::size_t N>
+        inline auto prefetch_state<T, N>::nb_buffers() const noexcept -> size_type
+        {
+            return m_slots.size();
+        }
+
+        template <class T, std::size_t N>
+        inline auto prefetch_state<T, N>::acquire(size_type index) -> const chunk_type&
+        {
+            slot& s = m_slots[index % m_slots.size()];
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this, &s]() { return s.m_ready || m_error; });
+            if (!s.m_ready)
+            {
+                std::rethrow_exception(m_error);
+            }
+            return s.m_data;
+        }
+
+        template <class T, std::size_t N>
+        inline void prefetch_state<T, N>::release(size_type index)
+        {
+            // Wait for the chunk even if it was not accessed, so that the
+            // slot is not handed back before being filled
+            slot& s = m_slots[index % m_slots.size()];
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_cv.wait(lock, [this, &s]() { return s.m_ready || m_error; });
+                s.m_ready = false;
+            }
+            m_cv.notify_all();
+        }
+
+        template <class T, std::size_t N>
+        inline void prefetch_state<T, N>::read_chunk(std::ifstream& in, size_type index, chunk_type& chunk) const
+        {
+            shape_type shape = m_shape;
+            size_type first_row = index * m_chunk_rows;
+            if (N != 0)
+            {
+                shape[0] = std::min(m_chunk_rows, m_shape[0] - first_row);
+            }
+            if (chunk.shape() != shape)
+            {
+                chunk.reshape(shape);
+            }
+            size_type count = compute_size(shape);
+            in.seekg(static_cast<std::streamoff>(m_data_offset + first_row * m_row_size * sizeof(T)));
+            in.read(reinterpret_cast<char*>(chunk.raw_data()), static_cast<std::streamsize>(count * sizeof(T)));
+            if (!in)
+            {
+                throw std::runtime_error("Unexpected end of file " + m_path);
+            }
+            if (m_swap_bytes)
+            {
+                std::size_t scalar_size = is_complex<T>::value ? sizeof(T) / 2 : sizeof(T);
+                swap_bytes(reinterpret_cast<char*>(chunk.raw_data()), count * sizeof(T) / scalar_size, scalar_size);
+            }
+        }
+    }
+
+    /***********************************
+     * xprefetch_reader implementation *
+     ***********************************/
+
+    /**
+     * @name Constructor
+     */
+    //@{
+    /**
+     * Constructs a reader over the row-major data stored in the specified file
+     * and starts reading its first chunks in the background.
+     * @param path the path of the file
+     * @param shape the shape of the whole array
+     * @param chunk_rows the number of rows (along the first axis) of a chunk
+     * @param nb_buffers the number of chunk buffers, at least 2
+     * @param data_offset the position of the first element in the file, in bytes
+     * @param swap_bytes whether the data was written with the opposite endianness
+     */
+    template <class T, std::size_t N>
+    inline xprefetch_reader<T, N>::xprefetch_reader(const std::string& path, const shape_type& shape,
+                                                    size_type chunk_rows, size_type nb_buffers,
+                                                    size_type data_offset, bool swap_bytes)
+        : p_state(std::make_unique<state_type>(path, shape, chunk_rows, nb_buffers, data_offset, swap_bytes))
+    {
+        state_type* state = p_state.get();
+        m_thread = std::thread([state]() { state->run(); });
+    }
+
+    /**
+     * Stops the background thread.
+     */
+    template <class T, std::size_t N>
+    inline xprefetch_reader<T, N>::~xprefetch_reader()
+    {
+        stop();
+    }
+
+    template <class T, std::size_t N>
+    inline auto xprefetch_reader<T, N>::operator=(xprefetch_reader&& rhs) -> xprefetch_reader&
+    {
+        stop();
+        p_state = std::move(rhs.p_state);
+        m_thread = std::move(rhs.m_thread);
+        return *this;
+    }
+    //@}
+
+    /**
+     * Returns the shape of the whole array.
+     */
+    template <class T, std::size_t N>
+    inline auto xprefetch_reader<T, N>::shape() const noexcept -> const shape_type&
+    {
+        return p_state->m_shape;
+    }
+
+    /**
+     * Returns the number of rows of a chunk; the last chunk may be smaller.
+     */
+    template <class T, std::size_t N>
+    inline auto xprefetch_reader<T, N>::chunk_rows() const noexcept -> size_type
+    {
+        return p_state->m_chunk_rows;
+    }
+
+    /**
+     * Returns the number of chunks.
+     */
+    template <class T, std::size_t N>
+    inline auto xprefetch_reader<T, N>::nb_chunks() const noexcept -> size_type
+    {
+        return p_state->m_nb_chunks;
+    }
+
+    /**
+     * Returns the number of chunk buffers.
+     */
+    template <class T, std::size_t N>
+    inline auto xprefetch_reader<T, N>::nb_buffers() const noexcept -> size_type
+    {
+        return p_state->nb_buffers();
+    }
+
+    /**
+     * Returns an iterator to the first chunk. The chunks can only be visited once.
+     */
+    template <class T, std::size_t N>
+    inline auto xprefetch_reader<T, N>::begin() -> iterator
+    {
+        return iterator(this, 0);
+    }
+
+    /**
+     * Returns an iterator past the last chunk.
+     */
+    template <class T, std::size_t N>
+    inline auto xprefetch_reader<T, N>::end() -> iterator
+    {
+        return iterator(this, nb_chunks());
+    }
+
+    template <class T, std::size_t N>
+    inline void xprefetch_reader<T, N>::stop()
+    {
+        if (p_state)
+        {
+            p_state->stop();
+        }
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+    }
+
+    /**
+     * @brief Creates a prefetching reader over a file array.
+     *
+     * Returns a xprefetch_reader over the file viewed by \c a, which must be
+     * a row-major array of dimension \c N.
+     * @param a the file array to read
+     * @param chunk_rows the number of rows (along the first axis) of a chunk
+     * @param nb_buffers the number of chunk buffers, at least 2
+     */
+    template <std::size_t N, class T>
+    inline xprefetch_reader<T, N> make_prefetch_reader(const xfile_array<T>& a, std::size_t chunk_rows,
+                                                       std::size_t nb_buffers)
+    {
+        std::array<std::size_t, N> shape;
+        if (a.dimension() != N || (N > 1 && a.layout() != layout::row_major))
+        {
+            throw std::runtime_error("Prefetching requires a row-major array of matching dimension");
+        }
+        std::copy(a.shape().cbegin(), a.shape().cend(), shape.begin());
+        bool swap = a.swap_bytes();
+        return xprefetch_reader<T, N>(a.path(), shape, chunk_rows, nb_buffers, a.data_offset(), swap);
+    }
+
+    /*************************************
+     * xprefetch_iterator implementation *
+     *************************************/
+
+    template <class T, std::size_t N>
+    inline xprefetch_iterator<T, N>::xprefetch_iterator(reader_type* reader, size_type index) noexcept
+        : p_reader(reader), m_index(index)
+    {
+    }
+
+    template <class T, std::size_t N>
+    inline auto xprefetch_iterator<T, N>::operator*() const -> reference
+    {
+        return p_reader->p_state->acquire(m_index);
+    }
+
+    template <class T, std::size_t N>
+    inline auto xprefetch_iterator<T, N>::operator->() const -> pointer
+    {
+        return &(operator*());
+    }
+
+    template <class T, std::size_t N>
+    inline auto xprefetch_iterator<T, N>::operator++() -> self_type&
+    {
+        p_reader->p_state->release(m_index);
+        ++m_index;
+        return *this;
+    }
+
+    template <class T, std::size_t N>
+    inline bool xprefetch_iterator<T, N>::equal(const self_type& rhs) const noexcept
+    {
+        return p_reader == rhs.p_reader && m_index == rhs.m_index;
+    }
+
+    template <class T, std::size_t N>
+    inline bool operator==(const xprefetch_iterator<T, N>& lhs, const xprefetch_iterator<T, N>& rhs) noexcept
+    {
+        return lhs.equal(rhs);
+    }
+
+    template <class T, std::size_t N>
+    inline bool operator!=(const xprefetch_iterator<T, N>& lhs, const xprefetch_iterator<T, N>& rhs) noexcept
+    {
+        return !lhs.equal(rhs);
+    }
+}
+
+#endif
@@ -13,11 +13,25 @@
 #ifndef XRANDOM_HPP
 #define XRANDOM_HPP
 
-#include <functional>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <numeric>
 #include <random>
+#include <stdexcept>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
+#include "xarray.hpp"
+#include "xexecution.hpp"
 #include "xgenerator.hpp"
+#include "xtensor.hpp"
 
 namespace xt
 {
@@ -33,6 +47,8 @@ namespace xt
         default_engine_type& get_default_random_engine();
         void seed(seed_type seed);
 
+        class philox4x32;
+
         template <class T, class S, class E = random::default_engine_type>
         auto rand(const S& shape, T lower = 0, T upper = 1,
                   E& engine = random::get_default_random_engine());
@@ -45,6 +61,22 @@ namespace xt
         auto randn(const S& shape, T mean = 0, T std_dev = 1,
                    E& engine = random::get_default_random_engine());
 
+        template <class T, class S, class E = random::default_engine_type>
+        auto exponential(const S& shape, T rate = 1,
+                         E& engine = random::get_default_random_engine());
+
+        template <class T, class S, class E = random::default_engine_type>
+        auto gamma(const S& shape, T alpha = 1, T beta = 1,
+                   E& engine = random::get_default_random_engine());
+
+        template <class T, class S, class E = random::default_engine_type>
+        auto binomial(const S& shape, T trials = 1, double prob = 0.5,
+                      E& engine = random::get_default_random_engine());
+
+        template <class T, class S, class E = random::default_engine_type>
+        auto poisson(const S& shape, double rate = 1.0,
+                     E& engine = random::get_default_random_engine());
+
 #ifdef X_OLD_CLANG
         template <class T, class I, class E = random::default_engine_type>
         auto rand(std::initializer_list<I> shape, T lower = 0, T upper = 1,
@@ -58,6 +90,22 @@ namespace xt
         template <class T, class I, class E = random::default_engine_type>
         auto randn(std::initializer_list<I>, T mean = 0, T std_dev = 1,
                    E& engine = random::get_default_random_engine());
+
+        template <class T, class I, class E = random::default_engine_type>
+        auto exponential(std::initializer_list<I> shape, T rate = 1,
+                         E& engine = random::get_default_random_engine());
+
+        template <class T, class I, class E = random::default_engine_type>
+        auto gamma(std::initializer_list<I> shape, T alpha = 1, T beta = 1,
+                   E& engine = random::get_default_random_engine());
+
+        template <class T, class I, class E = random::default_engine_type>
+        auto binomial(std::initializer_list<I> shape, T trials = 1, double prob = 0.5,
+                      E& engine = random::get_default_random_engine());
+
+        template <class T, class I, class E = random::default_engine_type>
+        auto poisson(std::initializer_list<I> shape, double rate = 1.0,
+                     E& engine = random::get_default_random_engine());
 #else
         template <class T, class I, std::size_t L, class E = random::default_engine_type>
         auto rand(const I (&shape)[L], T lower = 0, T upper = 1,
@@ -70,51 +118,484 @@ namespace xt
         template <class T, class I, std::size_t L, class E = random::default_engine_type>
         auto randn(const I (&shape)[L], T mean = 0, T std_dev = 1,
                    E& engine = random::get_default_random_engine());
+
+        template <class T, class I, std::size_t L, class E = random::default_engine_type>
+        auto exponential(const I (&shape)[L], T rate = 1,
+                         E& engine = random::get_default_random_engine());
+
+        template <class T, class I, std::size_t L, class E = random::default_engine_type>
+        auto gamma(const I (&shape)[L], T alpha = 1, T beta = 1,
+                   E& engine = random::get_default_random_engine());
+
+        template <class T, class I, std::size_t L, class E = random::default_engine_type>
+        auto binomial(const I (&shape)[L], T trials = 1, double prob = 0.5,
+                      E& engine = random::get_default_random_engine());
+
+        template <class T, class I, std::size_t L, class E = random::default_engine_type>
+        auto poisson(const I (&shape)[L], double rate = 1.0,
+                     E& engine = random::get_default_random_engine());
 #endif
+
+        template <class T, class E = random::default_engine_type>
+        void shuffle(xexpression<T>& e, std::size_t axis = 0,
+                     E& engine = random::get_default_random_engine());
+
+        template <class T, class E = random::default_engine_type>
+        std::enable_if_t<std::is_integral<T>::value, xtensor<T, 1>>
+        permutation(T n, E& engine = random::get_default_random_engine());
+
+        template <class T, class E = random::default_engine_type>
+        xarray<typename T::value_type>
+        permutation(const xexpression<T>& e, std::size_t axis = 0,
+                    E& engine = random::get_default_random_engine());
+
+        template <class T, class E = random::default_engine_type>
+        xtensor<typename T::value_type, 1>
+        choice(const xexpression<T>& e, std::size_t n, bool replace = true,
+               E& engine = random::get_default_random_engine());
+
+        template <class T, class W, class E = random::default_engine_type>
+        xtensor<typename T::value_type, 1>
+        choice(const xexpression<T>& e, std::size_t n, const xexpression<W>& weights,
+               bool replace = true, E& engine = random::get_default_random_engine());
+    }
+
+    /**************
+     * philox4x32 *
+     **************/
+
+    namespace random
+    {
+        /**
+         * @class philox4x32
+         * @brief Counter-based random number engine.
+         *
+         * Philox4x32-10 engine (Salmon et al., "Parallel random numbers: as
+         * easy as 1, 2, 3", 2011). Each 128-bit counter is mapped to four
+         * 32-bit words by a keyed bijection, so the n-th block of output only
+         * depends on the seed, the stream and n. Random expressions built on
+         * this engine compute every element from its flat index: they can be
+         * evaluated in any order, in chunks or in parallel, with bit-identical
+         * results.
+         *
+         * The class also models the standard uniform random bit generator
+         * requirements and can be used with the distributions of \c <random>.
+         * Streams with the most significant bit set are reserved for the
+         * substreams of the engine.
+         */
+        class philox4x32
+        {
+
+        public:
+
+            using result_type = std::uint32_t;
+            using block_type = std::array<std::uint32_t, 4>;
+
+            explicit philox4x32(std::uint64_t seed = 0, std::uint64_t stream = 0) noexcept;
+
+            void seed(std::uint64_t seed, std::uint64_t stream = 0) noexcept;
+
+            static constexpr result_type min() noexcept;
+            static constexpr result_type max() noexcept;
+
+            result_type operator()() noexcept;
+            void discard(std::uint64_t n) noexcept;
+
+            block_type block(std::uint64_t counter) const noexcept;
+            std::uint64_t counter() const noexcept;
+            void advance(std::uint64_t nb_blocks) noexcept;
+
+            philox4x32 substream(std::uint64_t index) const noexcept;
+
+        private:
+
+            std::array<std::uint32_t, 2> m_key;
+            std::uint64_t m_stream;
+            std::uint64_t m_counter;
+            block_type m_buffer;
+            std::size_t m_buffer_pos;
+        };
     }
 
     namespace detail
     {
+        // Uniform double in [0, 1) built from 53 random bits
+        inline double uniform_from_bits(std::uint32_t hi, std::uint32_t lo) noexcept
+        {
+            return ((hi >> 5) * 67108864.0 + (lo >> 6)) * (1.0 / 9007199254740992.0);
+        }
+
         template <class T>
-        struct random_impl
+        inline T counter_sample(const std::uniform_real_distribution<T>& dist, const random::philox4x32::block_type& r)
         {
-            using value_type = T;
+            T res = dist.a() + (dist.b() - dist.a()) * static_cast<T>(uniform_from_bits(r[0], r[1]));
+            // Rounding to a narrower T may reach the excluded upper bound
+            return res < dist.b() ? res : dist.a();
+        }
 
-            random_impl(std::function<value_type()>&& generator)
-                : m_generator(std::move(generator))
+        template <class T>
+        inline T counter_sample(const std::normal_distribution<T>& dist, const random::philox4x32::block_type& r)
+        {
+            // Box-Muller transform, u1 in (0, 1]
+            double u1 = 1.0 - uniform_from_bits(r[0], r[1]);
+            double u2 = uniform_from_bits(r[2], r[3]);
+            double z = std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+            return dist.mean() + dist.stddev() * static_cast<T>(z);
+        }
+
+        // The modulo bias is below range / 2^64
+        template <class T>
+        inline T counter_sample(const std::uniform_int_distribution<T>& dist, const random::philox4x32::block_type& r)
+        {
+            using unsigned_type = std::make_unsigned_t<T>;
+            std::uint64_t x = (std::uint64_t(r[0]) << 32) | r[1];
+            std::uint64_t range = std::uint64_t(unsigned_type(unsigned_type(dist.b()) - unsigned_type(dist.a()))) + 1;
+            std::uint64_t offset = range == 0 ? x : x % range;
+            return static_cast<T>(unsigned_type(unsigned_type(dist.a()) + unsigned_type(offset)));
+        }
+
+        template <class T>
+        inline T counter_sample(const std::exponential_distribution<T>& dist, const random::philox4x32::block_type& r)
+        {
+            // Inversion, 1 - u in (0, 1]
+            double u = 1.0 - uniform_from_bits(r[0], r[1]);
+            return static_cast<T>(-std::log(u)) / dist.lambda();
+        }
+
+        // Distributions sampled with a single block
+        template <class D>
+        inline auto counter_draw(const D& dist, const random::philox4x32& engine, std::uint64_t counter, int)
+            -> decltype(counter_sample(dist, engine.block(counter)))
+        {
+            return counter_sample(dist, engine.block(counter));
+        }
+
+        // Rejection samplers consume a variable number of words: they draw
+        // from the substream of the element, with a fresh distribution so
+        // that no state is carried between elements
+        template <class D>
+        inline typename D::result_type counter_draw(const D& dist, const random::philox4x32& engine, std::uint64_t counter, long)
+        {
+            random::philox4x32 sub = engine.substream(counter);
+            D d(dist.param());
+            return d(sub);
+        }
+
+        template <class D, class E>
+        class random_impl
+        {
+
+        public:
+
+            using value_type = typename D::result_type;
+
+            random_impl(D&& dist, E& engine)
+                : m_dist(std::move(dist)), p_engine(&engine)
             {
             }
 
             template <class... Args>
             inline value_type operator()(Args...) const
             {
-                return m_generator();
+                return m_dist(*p_engine);
             }
 
             template <class It>
             inline value_type element(It, It) const
             {
-                return m_generator();
+                return m_dist(*p_engine);
+            }
+
+            // Contiguous destinations are filled in one pass, drawing the
+            // same sequence as the element-wise evaluation
+            template <class C, class S>
+            inline bool assign_to(C& c, const S& shape) const
+            {
+                auto* data = linear_storage(c, shape);
+                if (data == nullptr)
+                {
+                    return false;
+                }
+                using storage_type = std::decay_t<decltype(*data)>;
+                std::size_t size = compute_size(shape);
+                for (std::size_t k = 0; k < size; ++k)
+                {
+                    data[k] = static_cast<storage_type>(m_dist(*p_engine));
+                }
+                return true;
             }
 
         private:
-            std::function<value_type()> m_generator;
+
+            mutable D m_dist;
+            E* p_engine;
         };
+
+        template <class D>
+        struct counter_random_impl
+        {
+            using value_type = typename D::result_type;
+
+            template <class S>
+            counter_random_impl(D&& dist, const random::philox4x32& engine, const S& shape)
+                : m_dist(std::move(dist)), m_engine(engine), m_base(engine.counter()),
+                  m_strides(std::begin(shape), std::end(shape))
+            {
+                std::size_t stride = 1;
+                for (std::size_t d = m_strides.size(); d != 0; --d)
+                {
+                    std::size_t extent = m_strides[d - 1];
+                    m_strides[d - 1] = stride;
+                    stride *= extent;
+                }
+            }
+
+            template <class... Args>
+            inline value_type operator()(Args... args) const
+            {
+                std::array<std::size_t, sizeof...(Args)> index = {{static_cast<std::size_t>(args)...}};
+                return element(index.cbegin(), index.cend());
+            }
+
+            template <class It>
+            inline value_type element(It first, It last) const
+            {
+                // Extra leading indices are dropped, missing ones map the
+                // given indices onto the leading strides, as element_offset
+                std::size_t nb_indices = static_cast<std::size_t>(std::distance(first, last));
+                if (nb_indices > m_strides.size())
+                {
+                    std::advance(first, static_cast<std::ptrdiff_t>(nb_indices - m_strides.size()));
+                }
+                std::uint64_t flat = 0;
+                for (std::size_t d = 0; first != last; ++first, ++d)
+                {
+                    flat += static_cast<std::uint64_t>(*first) * m_strides[d];
+                }
+                return counter_draw(m_dist, m_engine, m_base + flat, 0);
+            }
+
+            // Elements are independent: contiguous destinations are filled
+            // by blocks, in parallel when the execution policy allows it
+            template <class C, class S>
+            inline bool assign_to(C& c, const S& shape) const
+            {
+                auto* data = linear_storage(c, shape);
+                if (data == nullptr)
+                {
+                    return false;
+                }
+                using storage_type = std::decay_t<decltype(*data)>;
+                auto fill = [this, data](std::size_t first, std::size_t last) {
+                    for (std::size_t k = first; k < last; ++k)
+                    {
+                        data[k] = static_cast<storage_type>(counter_draw(m_dist, m_engine, m_base + k, 0));
+                    }
+                };
+                std::size_t size = compute_size(shape);
+                if (use_parallel(size))
+                {
+                    parallel_for(0, size, execution_options::execution_options().grain_size, fill);
+                }
+                else
+                {
+                    fill(0, size);
+                }
+                return true;
+            }
+
+        private:
+
+            D m_dist;
+            random::philox4x32 m_engine;
+            std::uint64_t m_base;
+            std::vector<std::size_t> m_strides;
+        };
+
+        // Distributions are moved into the generator rather than copied:
+        // some of them, such as std::poisson_distribution, leave the
+        // parameters they do not use uninitialized.
+        template <class D, class S, class E>
+        inline auto make_random_xgenerator(D dist, const S& shape, E& engine)
+        {
+            return make_xgenerator(random_impl<D, E>(std::move(dist), engine), shape);
+        }
+
+        // Counter-based engines reserve one block per element and map each
+        // element to the block of its flat index.
+        template <class D, class S>
+        inline auto make_random_xgenerator(D dist, const S& shape, random::philox4x32& engine)
+        {
+            std::uint64_t size = 1;
+            for (auto it = std::begin(shape); it != std::end(shape); ++it)
+            {
+                size *= static_cast<std::uint64_t>(*it);
+            }
+            counter_random_impl<D> impl(std::move(dist), engine, shape);
+            engine.advance(size);
+            return make_xgenerator(std::move(impl), shape);
+        }
+
+        // Walker's alias method (Vose's construction): O(n) setup, then
+        // O(1) per draw for an arbitrary discrete distribution
+        class alias_table
+        {
+
+        public:
+
+            template <class It>
+            alias_table(It first, It last);
+
+            template <class E>
+            std::size_t operator()(E& engine) const;
+
+        private:
+
+            std::vector<double> m_prob;
+            std::vector<std::size_t> m_alias;
+        };
+
+        template <class It>
+        inline alias_table::alias_table(It first, It last)
+            : m_prob(first, last), m_alias(m_prob.size())
+        {
+            std::size_t n = m_prob.size();
+            double total = 0.;
+            for (double w : m_prob)
+            {
+                if (!(w >= 0.))
+                {
+                    throw std::runtime_error("alias_table: weights must be non-negative");
+                }
+                total += w;
+            }
+            if (!(total > 0.))
+            {
+                throw std::runtime_error("alias_table: weights must not all be zero");
+            }
+
+            std::vector<std::size_t> small, large;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                m_prob[i] *= double(n) / total;
+                m_alias[i] = i;
+                (m_prob[i] < 1. ? small : large).push_back(i);
+            }
+            while (!small.empty() && !large.empty())
+            {
+                std::size_t s = small.back();
+                std::size_t l = large.back();
+                small.pop_back();
+                m_alias[s] = l;
+                m_prob[l] -= 1. - m_prob[s];
+                if (m_prob[l] < 1.)
+                {
+                    large.pop_back();
+                    small.push_back(l);
+                }
+            }
+            // Leftovers only differ from 1 by rounding errors
+            for (std::size_t i : small)
+            {
+                m_prob[i] = 1.;
+            }
+            for (std::size_t i : large)
+            {
+                m_prob[i] = 1.;
+            }
+        }
+
+        template <class E>
+        inline std::size_t alias_table::operator()(E& engine) const
+        {
+            std::uniform_int_distribution<std::size_t> column(0, m_prob.size() - 1);
+            std::uniform_real_distribution<double> coin(0., 1.);
+            std::size_t i = column(engine);
+            return coin(engine) < m_prob[i] ? i : m_alias[i];
+        }
+
+        // Offsets in the storage of the elements of the first hyperplane
+        // orthogonal to axis
+        template <class C>
+        inline std::vector<std::ptrdiff_t> hyperplane_offsets(const C& c, std::size_t axis)
+        {
+            const auto& shape = c.shape();
+            const auto& strides = c.strides();
+            std::size_t size = 1;
+            for (std::size_t d = 0; d < shape.size(); ++d)
+            {
+                size *= d == axis ? std::size_t(1) : std::size_t(shape[d]);
+            }
+            std::vector<std::ptrdiff_t> offsets(size);
+            std::vector<std::size_t> index(shape.size(), 0);
+            std::ptrdiff_t offset = 0;
+            for (std::size_t k = 0; k < size; ++k)
+            {
+                offsets[k] = offset;
+                for (std::size_t d = shape.size(); d != 0; --d)
+                {
+                    std::size_t i = d - 1;
+                    if (i == axis)
+                    {
+                        continue;
+                    }
+                    if (++index[i] != shape[i])
+                    {
+                        offset += std::ptrdiff_t(strides[i]);
+                        break;
+                    }
+                    offset -= std::ptrdiff_t(strides[i]) * std::ptrdiff_t(shape[i] - 1);
+                    index[i] = 0;
+                }
+            }
+            return offsets;
+        }
+
+        template <class T, class E>
+        inline void shuffle_indices(std::vector<T>& indices, std::size_t n, E& engine)
+        {
+            // Partial Fisher-Yates: the first n entries are a uniform sample
+            std::size_t size = indices.size();
+            for (std::size_t i = 0; i < n && i + 1 < size; ++i)
+            {
+                std::uniform_int_distribution<std::size_t> dist(i, size - 1);
+                std::swap(indices[i], indices[dist(engine)]);
+            }
+        }
+
+        // Threads of the pool never take the default seed, so that the
+        // first other thread requesting an engine, in practice the main
+        // thread, draws the same sequence in every run
+        inline random::seed_type default_engine_seed()
+        {
+            using engine_type = random::default_engine_type;
+            static std::atomic<bool> default_seed_taken(false);
+            static std::atomic<random::seed_type> nb_other_engines(0);
+            if (current_worker().pool == nullptr && !default_seed_taken.exchange(true))
+            {
+                return engine_type::default_seed;
+            }
+            return engine_type::default_seed + 1 + nb_other_engines++;
+        }
     }
 
     namespace random
     {
         /**
-         * Returns a reference to the default random number engine
+         * Returns a reference to the default random number engine of the
+         * calling thread. The engine of the first thread requesting it that
+         * is not a thread of the pool is seeded with the default seed, the
+         * engines of the other threads with distinct seeds, so that threads
+         * never share a random sequence.
          */
         inline default_engine_type& get_default_random_engine()
         {
-            static default_engine_type mt;
+            static thread_local default_engine_type mt(detail::default_engine_seed());
             return mt;
         }
 
         /**
-         * Seeds the default random number generator with @p seed
+         * Seeds the default random number engine of the calling thread with @p seed
          * @param seed The seed
          */
         inline void seed(seed_type seed)
@@ -137,8 +618,7 @@ namespace xt
         template <class T, class S, class E>
         inline auto rand(const S& shape, T lower, T upper, E& engine)
         {
-            std::uniform_real_distribution<T> dist(lower, upper);
-            return detail::make_xgenerator(detail::random_impl<T>(std::bind(dist, std::ref(engine))), shape);
+            return detail::make_random_xgenerator(std::uniform_real_distribution<T>(lower, upper), shape, engine);
         }
 
         /**
@@ -156,8 +636,7 @@ namespace xt
         template <class T, class S, class E>
         inline auto randint(const S& shape, T lower, T upper, E& engine)
         {
-            std::uniform_int_distribution<T> dist(lower, upper - 1);
-            return detail::make_xgenerator(detail::random_impl<T>(std::bind(dist, std::ref(engine))), shape);
+            return detail::make_random_xgenerator(std::uniform_int_distribution<T>(lower, upper - 1), shape, engine);
         }
 
         /**
@@ -176,53 +655,503 @@ namespace xt
         template <class T, class S, class E>
         inline auto randn(const S& shape, T mean, T std_dev, E& engine)
         {
-            std::normal_distribution<T> dist(mean, std_dev);
-            return detail::make_xgenerator(detail::random_impl<T>(std::bind(dist, std::ref(engine))), shape);
+            return detail::make_random_xgenerator(std::normal_distribution<T>(mean, std_dev), shape, engine);
+        }
+
+        /**
+         * xexpression with specified @p shape containing numbers sampled from
+         * the exponential distribution with rate @p rate.
+         *
+         * Numbers are drawn from @c std::exponential_distribution.
+         *
+         * @param shape shape of resulting xexpression
+         * @param rate rate (inverse of the mean) of the distribution
+         * @param engine random number engine
+         * @tparam T number type to use
+         */
+        template <class T, class S, class E>
+        inline auto exponential(const S& shape, T rate, E& engine)
+        {
+            return detail::make_random_xgenerator(std::exponential_distribution<T>(rate), shape, engine);
+        }
+
+        /**
+         * xexpression with specified @p shape containing numbers sampled from
+         * the gamma distribution with shape parameter @p alpha and scale
+         * parameter @p beta.
+         *
+         * Numbers are drawn from @c std::gamma_distribution.
+         *
+         * @param shape shape of resulting xexpression
+         * @param alpha shape parameter of the distribution
+         * @param beta scale parameter of the distribution
+         * @param engine random number engine
+         * @tparam T number type to use
+         */
+        template <class T, class S, class E>
+        inline auto gamma(const S& shape, T alpha, T beta, E& engine)
+        {
+            return detail::make_random_xgenerator(std::gamma_distribution<T>(alpha, beta), shape, engine);
+        }
+
+        /**
+         * xexpression with specified @p shape containing the numbers of
+         * successes in @p trials independent trials of probability @p prob.
+         *
+         * Numbers are drawn from @c std::binomial_distribution.
+         *
+         * @param shape shape of resulting xexpression
+         * @param trials number of trials
+         * @param prob probability of success of each trial
+         * @param engine random number engine
+         * @tparam T integer type to use
+         */
+        template <class T, class S, class E>
+        inline auto binomial(const S& shape, T trials, double prob, E& engine)
+        {
+            return detail::make_random_xgenerator(std::binomial_distribution<T>(trials, prob), shape, engine);
+        }
+
+        /**
+         * xexpression with specified @p shape containing numbers sampled from
+         * the Poisson distribution with mean @p rate.
+         *
+         * Numbers are drawn from @c std::poisson_distribution.
+         *
+         * @param shape shape of resulting xexpression
+         * @param rate mean of the distribution
+         * @param engine random number engine
+         * @tparam T integer type to use
+         */
+        template <class T, class S, class E>
+        inline auto poisson(const S& shape, double rate, E& engine)
+        {
+            return detail::make_random_xgenerator(std::poisson_distribution<T>(rate), shape, engine);
         }
 
 #ifdef X_OLD_CLANG
         template <class T, class I, class E>
         inline auto rand(std::initializer_list<I> shape, T lower, T upper, E& engine)
         {
-            std::uniform_real_distribution<T> dist(lower, upper);
-            return detail::make_xgenerator(detail::random_impl<T>(std::bind(dist, std::ref(engine))), shape);
+            return detail::make_random_xgenerator(std::uniform_real_distribution<T>(lower, upper), shape, engine);
         }
 
         template <class T, class I, class E>
         inline auto randint(std::initializer_list<I> shape, T lower, T upper, E& engine)
         {
-            std::uniform_int_distribution<T> dist(lower, upper - 1);
-            return detail::make_xgenerator(detail::random_impl<T>(std::bind(dist, std::ref(engine))), shape);
+            return detail::make_random_xgenerator(std::uniform_int_distribution<T>(lower, upper - 1), shape, engine);
         }
 
         template <class T, class I, class E>
         inline auto randn(std::initializer_list<I> shape, T mean, T std_dev, E& engine)
         {
-            std::normal_distribution<T> dist(mean, std_dev);
-            return detail::make_xgenerator(detail::random_impl<T>(std::bind(dist, std::ref(engine))), shape);
+            return detail::make_random_xgenerator(std::normal_distribution<T>(mean, std_dev), shape, engine);
+        }
+
+        template <class T, class I, class E>
+        inline auto exponential(std::initializer_list<I> shape, T rate, E& engine)
+        {
+            return detail::make_random_xgenerator(std::exponential_distribution<T>(rate), shape, engine);
+        }
+
+        template <class T, class I, class E>
+        inline auto gamma(std::initializer_list<I> shape, T alpha, T beta, E& engine)
+        {
+            return detail::make_random_xgenerator(std::gamma_distribution<T>(alpha, beta), shape, engine);
+        }
+
+        template <class T, class I, class E>
+        inline auto binomial(std::initializer_list<I> shape, T trials, double prob, E& engine)
+        {
+            return detail::make_random_xgenerator(std::binomial_distribution<T>(trials, prob), shape, engine);
+        }
+
+        template <class T, class I, class E>
+        inline auto poisson(std::initializer_list<I> shape, double rate, E& engine)
+        {
+            return detail::make_random_xgenerator(std::poisson_distribution<T>(rate), shape, engine);
         }
 #else
         template <class T, class I, std::size_t L, class E>
         inline auto rand(const I (&shape)[L], T lower, T upper, E& engine)
         {
-            std::uniform_real_distribution<T> dist(lower, upper);
-            return detail::make_xgenerator(detail::random_impl<T>(std::bind(dist, std::ref(engine))), shape);
+            return detail::make_random_xgenerator(std::uniform_real_distribution<T>(lower, upper), shape, engine);
         }
 
         template <class T, class I, std::size_t L, class E>
         inline auto randint(const I (&shape)[L], T lower, T upper, E& engine)
         {
-            std::uniform_int_distribution<T> dist(lower, upper - 1);
-            return detail::make_xgenerator(detail::random_impl<T>(std::bind(dist, std::ref(engine))), shape);
+            return detail::make_random_xgenerator(std::uniform_int_distribution<T>(lower, upper - 1), shape, engine);
         }
 
         template <class T, class I, std::size_t L, class E>
         inline auto randn(const I (&shape)[L], T mean, T std_dev, E& engine)
         {
-            std::normal_distribution<T> dist(mean, std_dev);
-            return detail::make_xgenerator(detail::random_impl<T>(std::bind(dist, std::ref(engine))), shape);
+            return detail::make_random_xgenerator(std::normal_distribution<T>(mean, std_dev), shape, engine);
+        }
+
+        template <class T, class I, std::size_t L, class E>
+        inline auto exponential(const I (&shape)[L], T rate, E& engine)
+        {
+            return detail::make_random_xgenerator(std::exponential_distribution<T>(rate), shape, engine);
+        }
+
+        template <class T, class I, std::size_t L, class E>
+        inline auto gamma(const I (&shape)[L], T alpha, T beta, E& engine)
+        {
+            return detail::make_random_xgenerator(std::gamma_distribution<T>(alpha, beta), shape, engine);
+        }
+
+        template <class T, class I, std::size_t L, class E>
+        inline auto binomial(const I (&shape)[L], T trials, double prob, E& engine)
+        {
+            return detail::make_random_xgenerator(std::binomial_distribution<T>(trials, prob), shape, engine);
+        }
+
+        template <class T, class I, std::size_t L, class E>
+        inline auto poisson(const I (&shape)[L], double rate, E& engine)
+        {
+            return detail::make_random_xgenerator(std::poisson_distribution<T>(rate), shape, engine);
         }
 #endif
+
+        /**
+         * Shuffles the container @p e in place along the axis @p axis: the
+         * hyperplanes orthogonal to @p axis are permuted, their content is
+         * left unchanged.
+         *
+         * @param e the container to shuffle
+         * @param axis the axis along which the container is shuffled
+         * @param engine random number engine
+         */
+        template <class T, class E>
+        inline void shuffle(xexpression<T>& e, std::size_t axis, E& engine)
+        {
+            T& c = e.derived_cast();
+            if (axis >= c.dimension())
+            {
+                throw std::runtime_error("shuffle: axis out of bounds");
+            }
+            std::size_t n = c.shape()[axis];
+            std::ptrdiff_t stride = std::ptrdiff_t(c.strides()[axis]);
+            std::vector<std::ptrdiff_t> offsets = detail::hyperplane_offsets(c, axis);
+            if (offsets.empty())
+            {
+                return;
+            }
+            auto* data = c.raw_data() + c.raw_data_offset();
+            bool contiguous = true;
+            for (std::size_t k = 0; k < offsets.size() && contiguous; ++k)
+            {
+                contiguous = offsets[k] == std::ptrdiff_t(k);
+            }
+            for (std::size_t i = n; i > 1; --i)
+            {
+                std::uniform_int_distribution<std::size_t> dist(0, i - 1);
+                std::size_t j = dist(engine);
+                if (j == i - 1)
+                {
+                    continue;
+                }
+                auto* lhs = data + std::ptrdiff_t(i - 1) * stride;
+                auto* rhs = data + std::ptrdiff_t(j) * stride;
+                if (contiguous)
+                {
+                    std::swap_ranges(lhs, lhs + offsets.size(), rhs);
+                }
+                else
+                {
+                    for (std::ptrdiff_t offset : offsets)
+                    {
+                        std::swap(lhs[offset], rhs[offset]);
+                    }
+                }
+            }
+        }
+
+        /**
+         * Returns a random permutation of the integers from 0 to @p n, excluding @p n.
+         *
+         * @param n the number of integers
+         * @param engine random number engine
+         */
+        template <class T, class E>
+        inline std::enable_if_t<std::is_integral<T>::value, xtensor<T, 1>>
+        permutation(T n, E& engine)
+        {
+            std::array<std::size_t, 1> shape = {{static_cast<std::size_t>(n)}};
+            xtensor<T, 1> res(shape);
+            std::iota(res.begin(), res.end(), T(0));
+            shuffle(res, 0, engine);
+            return res;
+        }
+
+        /**
+         * Returns a copy of @p e shuffled along the axis @p axis.
+         *
+         * @param e the expression to permute
+         * @param axis the axis along which the copy is shuffled
+         * @param engine random number engine
+         */
+        template <class T, class E>
+        inline xarray<typename T::value_type>
+        permutation(const xexpression<T>& e, std::size_t axis, E& engine)
+        {
+            xarray<typename T::value_type> res = e;
+            shuffle(res, axis, engine);
+            return res;
+        }
+
+        /**
+         * Returns @p n elements drawn from the elements of @p e, taken in
+         * row-major order.
+         *
+         * Without replacement, a partial Fisher-Yates shuffle of the indices
+         * is performed.
+         *
+         * @param e the population
+         * @param n the number of elements to draw
+         * @param replace whether an element can be drawn several times
+         * @param engine random number engine
+         */
+        template <class T, class E>
+        inline xtensor<typename T::value_type, 1>
+        choice(const xexpression<T>& e, std::size_t n, bool replace, E& engine)
+        {
+            const auto& de = e.derived_cast();
+            std::vector<typename T::value_type> values(de.begin(), de.end());
+            if (values.empty() ? n != 0 : !replace && n > values.size())
+            {
+                throw std::runtime_error("choice: sample larger than the population");
+            }
+            std::array<std::size_t, 1> shape = {{n}};
+            xtensor<typename T::value_type, 1> res(shape);
+            if (replace)
+            {
+                std::uniform_int_distribution<std::size_t> dist(0, values.size() - 1);
+                for (auto& r : res)
+                {
+                    r = values[dist(engine)];
+                }
+            }
+            else
+            {
+                detail::shuffle_indices(values, n, engine);
+                std::copy(values.begin(), values.begin() + std::ptrdiff_t(n), res.begin());
+            }
+            return res;
+        }
+
+        /**
+         * Returns @p n elements drawn from the elements of @p e, taken in
+         * row-major order, with probabilities proportional to @p weights.
+         *
+         * With replacement, elements are drawn from an alias table in
+         * constant time. Without replacement, the @p n elements with the
+         * largest keys <tt>log(u) / w</tt> are taken (Efraimidis and Spirakis).
+         *
+         * @param e the population
+         * @param n the number of elements to draw
+         * @param weights the non-negative weights of the elements of @p e
+         * @param replace whether an element can be drawn several times
+         * @param engine random number engine
+         */
+        template <class T, class W, class E>
+        inline xtensor<typename T::value_type, 1>
+        choice(const xexpression<T>& e, std::size_t n, const xexpression<W>& weights, bool replace, E& engine)
+        {
+            const auto& de = e.derived_cast();
+            const auto& dw = weights.derived_cast();
+            std::vector<typename T::value_type> values(de.begin(), de.end());
+            std::vector<double> w(dw.begin(), dw.end());
+            if (w.size() != values.size())
+            {
+                throw std::runtime_error("choice: weights and population must have the same size");
+            }
+            std::array<std::size_t, 1> shape = {{n}};
+            xtensor<typename T::value_type, 1> res(shape);
+            if (n == 0)
+            {
+                return res;
+            }
+            if (replace)
+            {
+                detail::alias_table table(w.cbegin(), w.cend());
+                for (auto& r : res)
+                {
+                    r = values[table(engine)];
+                }
+                return res;
+            }
+
+            std::size_t nb_candidates = 0;
+            std::vector<std::pair<double, std::size_t>> keys;
+            keys.reserve(w.size());
+            std::uniform_real_distribution<double> dist(0., 1.);
+            for (std::size_t i = 0; i < w.size(); ++i)
+            {
+                if (!(w[i] >= 0.))
+                {
+                    throw std::runtime_error("choice: weights must be non-negative");
+                }
+                double u = 1. - dist(engine);
+                double key = w[i] > 0. ? std::log(u) / w[i] : -std::numeric_limits<double>::infinity();
+                nb_candidates += w[i] > 0. ? 1 : 0;
+                keys.emplace_back(key, i);
+            }
+            if (n > nb_candidates)
+            {
+                throw std::runtime_error("choice: sample larger than the number of non-zero weights");
+            }
+            auto middle = keys.begin() + std::ptrdiff_t(n);
+            std::partial_sort(keys.begin(), middle, keys.end(), [](const auto& lhs, const auto& rhs) {
+                return lhs.first > rhs.first;
+            });
+            std::transform(keys.begin(), middle, res.begin(), [&values](const auto& k) {
+                return values[k.second];
+            });
+            return res;
+        }
+    }
+
+    /*****************************
+     * philox4x32 implementation *
+     *****************************/
+
+    namespace detail
+    {
+        inline void philox_round(random::philox4x32::block_type& ctr, const std::array<std::uint32_t, 2>& key) noexcept
+        {
+            std::uint64_t p0 = std::uint64_t(0xD2511F53) * ctr[0];
+            std::uint64_t p1 = std::uint64_t(0xCD9E8D57) * ctr[2];
+            ctr = {{std::uint32_t(p1 >> 32) ^ ctr[1] ^ key[0], std::uint32_t(p1),
+                    std::uint32_t(p0 >> 32) ^ ctr[3] ^ key[1], std::uint32_t(p0)}};
+        }
+    }
+
+    namespace random
+    {
+        /**
+         * Constructs an engine with the given key.
+         * @param seed the seed, used as the key of the bijection
+         * @param stream the index of the stream, giving independent
+         * sequences for a same seed
+         */
+        inline philox4x32::philox4x32(std::uint64_t seed, std::uint64_t stream) noexcept
+        {
+            this->seed(seed, stream);
+        }
+
+        /**
+         * Sets the key of the engine and resets its counter.
+         * @param seed the seed
+         * @param stream the index of the stream
+         */
+        inline void philox4x32::seed(std::uint64_t seed, std::uint64_t stream) noexcept
+        {
+            m_key = {{std::uint32_t(seed), std::uint32_t(seed >> 32)}};
+            m_stream = stream;
+            m_counter = 0;
+            m_buffer = {{0, 0, 0, 0}};
+            m_buffer_pos = 4;
+        }
+
+        constexpr philox4x32::result_type philox4x32::min() noexcept
+        {
+            return 0;
+        }
+
+        constexpr philox4x32::result_type philox4x32::max() noexcept
+        {
+            return 0xFFFFFFFF;
+        }
+
+        /**
+         * Returns the next random word.
+         */
+        inline auto philox4x32::operator()() noexcept -> result_type
+        {
+            if (m_buffer_pos == 4)
+            {
+                m_buffer = block(m_counter++);
+                m_buffer_pos = 0;
+            }
+            return m_buffer[m_buffer_pos++];
+        }
+
+        /**
+         * Skips the next \c n random words.
+         */
+        inline void philox4x32::discard(std::uint64_t n) noexcept
+        {
+            std::uint64_t buffered = 4 - m_buffer_pos;
+            if (n <= buffered)
+            {
+                m_buffer_pos += n;
+                return;
+            }
+            n -= buffered;
+            m_counter += n / 4;
+            m_buffer_pos = 4;
+            if (n % 4 != 0)
+            {
+                m_buffer = block(m_counter++);
+                m_buffer_pos = n % 4;
+            }
+        }
+
+        /**
+         * Returns the four random words of the specified block of the stream,
+         * without changing the state of the engine.
+         * @param counter the index of the block
+         */
+        inline auto philox4x32::block(std::uint64_t counter) const noexcept -> block_type
+        {
+            block_type ctr = {{std::uint32_t(counter), std::uint32_t(counter >> 32),
+                               std::uint32_t(m_stream), std::uint32_t(m_stream >> 32)}};
+            std::array<std::uint32_t, 2> key = m_key;
+            detail::philox_round(ctr, key);
+            for (std::size_t r = 1; r < 10; ++r)
+            {
+                key[0] += 0x9E3779B9;
+                key[1] += 0xBB67AE85;
+                detail::philox_round(ctr, key);
+            }
+            return ctr;
+        }
+
+        /**
+         * Returns the index of the next block produced by the engine.
+         */
+        inline std::uint64_t philox4x32::counter() const noexcept
+        {
+            return m_counter;
+        }
+
+        /**
+         * Skips the next \c nb_blocks blocks, dropping the words left in
+         * the current block.
+         */
+        inline void philox4x32::advance(std::uint64_t nb_blocks) noexcept
+        {
+            m_counter += nb_blocks;
+            m_buffer_pos = 4;
+        }
+
+        /**
+         * Returns an engine with the same key, producing the \c index-th
+         * substream of the engine. A substream holds 2^16 blocks; the first
+         * 2^48 substreams do not overlap each other nor the stream of the engine.
+         * @param index the index of the substream
+         */
+        inline philox4x32 philox4x32::substream(std::uint64_t index) const noexcept
+        {
+            philox4x32 res(*this);
+            res.m_stream = m_stream | (std::uint64_t(1) << 63);
+            res.m_counter = index << 16;
+            res.m_buffer_pos = 4;
+            return res;
+        }
     }
 }
 
@@ -10,6 +10,7 @@
 #define XREDUCER_HPP
 
 #include <algorithm>
+#include <array>
 #include <cstddef>
 #include <initializer_list>
 #include <iterator>
@@ -21,10 +22,12 @@
 #endif
 
 #include "xbuilder.hpp"
+#include "xexecution.hpp"
 #include "xexpression.hpp"
 #include "xgenerator.hpp"
 #include "xiterable.hpp"
 #include "xreducer.hpp"
+#include "xstorage.hpp"
 #include "xutils.hpp"
 
 namespace xt
@@ -59,6 +62,9 @@ namespace xt
     {
         template <class F, class CT, class X>
         class reducing_iterator;
+
+        template <class ST>
+        struct reducer_index_type;
     }
 
     template <class F, class CT, class X>
@@ -155,16 +161,20 @@ namespace xt
         template <class S>
         const_stepper stepper_end(const S& shape) const noexcept;
 
+        template <class E>
+        auto assign_to(E& e) const -> decltype(e.element(std::declval<const size_type*>(), std::declval<const size_type*>()), bool());
+
     private:
 
+        using index_type = typename detail::reducer_index_type<typename xexpression_type::shape_type>::type;
+
+        value_type tree_reduce(const index_type& index, size_type reduced_size, size_type block_size) const;
+
         CT m_e;
         functor_type m_f;
         axes_type m_axes;
         inner_shape_type m_shape;
 
-        using index_type = xindex_type_t<typename xexpression_type::shape_type>;
-        mutable index_type m_index;
-
         friend class detail::reducing_iterator<F, CT, X>;
     };
 
@@ -237,6 +247,21 @@ namespace xt
 
     namespace detail
     {
+        // Every evaluation of an element builds its own index over the
+        // reduced expression; it lives on the stack unless the expression
+        // has more than 8 dimensions.
+        template <class ST>
+        struct reducer_index_type
+        {
+            using type = index_buffer;
+        };
+
+        template <class V, std::size_t L>
+        struct reducer_index_type<std::array<V, L>>
+        {
+            using type = std::array<V, L>;
+        };
+
         template <class InputIt, class ExcludeIt, class OutputIt>
         inline void excluding_copy(InputIt first, InputIt last,
                                    ExcludeIt e_first, ExcludeIt e_last,
@@ -282,10 +307,11 @@ namespace xt
         }
 
         // This is not a true iterator since two instances
-        // of reducing_iterator on the same xreducer share
+        // of reducing_iterator on the same index share
         // the same state. However this allows optimization
         // and is not problematic since not in the public
-        // interface.
+        // interface. The index is owned by the caller, so
+        // concurrent evaluations of a reducer do not interfere.
         template <class F, class CT, class X>
         class reducing_iterator
         {
@@ -299,10 +325,10 @@ namespace xt
             using pointer = typename reducer_type::pointer;
             using difference_type = typename reducer_type::difference_type;
             using size_type = typename reducer_type::size_type;
+            using index_type = typename reducer_type::index_type;
             using iterator_category = std::forward_iterator_tag;
 
-            reducing_iterator() = default;
-            reducing_iterator(const reducer_type& reducer, bool end = false);
+            reducing_iterator(const reducer_type& reducer, index_type& index, bool end = false);
 
             self_type& operator++();
             self_type operator++(int);
@@ -319,6 +345,7 @@ namespace xt
             size_type shape(size_type index) const;
 
             const reducer_type& m_reducer;
+            index_type& m_index;
             bool m_end;
         };
 
@@ -341,8 +368,8 @@ namespace xt
          *************************************/
 
         template <class F, class CT, class X>
-        inline reducing_iterator<F, CT, X>::reducing_iterator(const reducer_type& reducer, bool end)
-            : m_reducer(reducer), m_end(end)
+        inline reducing_iterator<F, CT, X>::reducing_iterator(const reducer_type& reducer, index_type& index, bool end)
+            : m_reducer(reducer), m_index(index), m_end(end)
         {
         }
 
@@ -364,13 +391,13 @@ namespace xt
         template <class F, class CT, class X>
         inline auto reducing_iterator<F, CT, X>::operator*() const -> reference
         {
-            return m_reducer.m_e.element(m_reducer.m_index.cbegin(), m_reducer.m_index.cend());
+            return m_reducer.m_e.element(m_index.cbegin(), m_index.cend());
         }
 
         template <class F, class CT, class X>
         inline bool reducing_iterator<F, CT, X>::equal(const self_type& rhs) const
         {
-            return &m_reducer == &(rhs.m_reducer) && m_end == rhs.m_end;
+            return &m_index == &(rhs.m_index) && m_end == rhs.m_end;
         }
 
         template <class F, class CT, class X>
@@ -380,13 +407,13 @@ namespace xt
             while (i != 0)
             {
                 --i;
-                if (++(m_reducer.m_index[axes(i)]) != shape(axes(i)))
+                if (++(m_index[axes(i)]) != shape(axes(i)))
                 {
                     return;
                 }
                 else
                 {
-                    m_reducer.m_index[axes(i)] = 0;
+                    m_index[axes(i)] = 0;
                 }
             }
             if (i == 0)
@@ -428,8 +455,7 @@ namespace xt
     template <class Func, class CTA, class AX>
     inline xreducer<F, CT, X>::xreducer(Func&& func, CTA&& e, AX&& axes)
         : m_e(std::forward<CTA>(e)), m_f(std::forward<Func>(func)), m_axes(std::forward<AX>(axes)),
-          m_shape(make_sequence<shape_type>(m_e.dimension() - m_axes.size(), 0)),
-          m_index(make_sequence<index_type>(m_e.dimension(), 0))
+          m_shape(make_sequence<shape_type>(m_e.dimension() - m_axes.size(), 0))
     {
         if (!std::is_sorted(m_axes.cbegin(), m_axes.cend()))
         {
@@ -527,11 +553,25 @@ namespace xt
     template <class It>
     inline auto xreducer<F, CT, X>::element(It first, It last) const -> const_reference
     {
+        index_type index = make_sequence<index_type>(m_e.dimension(), size_type(0));
         detail::inject(first, last, m_axes.cbegin(), m_axes.cend(),
-                       m_index.begin(), size_type(0));
+                       index.begin(), size_type(0));
+        const auto& options = execution_options::execution_options();
+        if (options.deterministic_reduction)
+        {
+            size_type reduced_size = 1;
+            for (auto axis : m_axes)
+            {
+                reduced_size *= m_e.shape()[axis];
+            }
+            if (reduced_size > options.reduction_block_size)
+            {
+                return tree_reduce(index, reduced_size, options.reduction_block_size);
+            }
+        }
         using iter_type = detail::reducing_iterator<F, CT, X>;
-        iter_type iter = iter_type(*this);
-        iter_type iter_end = iter_type(*this, true);
+        iter_type iter = iter_type(*this, index);
+        iter_type iter_end = iter_type(*this, index, true);
         value_type init_value = *iter;
         value_type res = std::accumulate(++iter, iter_end, init_value, m_f);
         return res;
@@ -582,6 +622,108 @@ namespace xt
         size_type offset = shape.size() - dimension();
         return const_stepper(this, offset, true);
     }
+
+    /**
+     * Evaluates the reducer into \c e, splitting the output elements among
+     * threads when the parallel execution policy applies and the reduced
+     * expression can be read concurrently.
+     * @param e the expression to assign, whose shape must be the shape of the reducer
+     * @return false if the reducer is not evaluated, in which case the caller
+     * must fall back to the stepper-based assignment
+     */
+    template <class F, class CT, class X>
+    template <class E>
+    inline auto xreducer<F, CT, X>::assign_to(E& e) const
+        -> decltype(e.element(std::declval<const size_type*>(), std::declval<const size_type*>()), bool())
+    {
+        size_type out_size = size();
+        if (!is_concurrently_readable<xexpression_type>::value ||
+            out_size < 2 || e.dimension() != dimension() ||
+            !std::equal(m_shape.cbegin(), m_shape.cend(), e.shape().cbegin()) ||
+            !detail::use_parallel(m_e.size()))
+        {
+            return false;
+        }
+        size_type reduced_size = m_e.size() / out_size;
+        size_type grain = std::max(size_type(1), execution_options::execution_options().grain_size / std::max(reduced_size, size_type(1)));
+        parallel_for(0, out_size, grain, [this, &e](std::size_t first, std::size_t last) {
+            // Unravels first in row-major order, then walks the output
+            inner_shape_type index = m_shape;
+            size_type linear = first;
+            for (size_type d = dimension(); d != 0; --d)
+            {
+                index[d - 1] = linear % m_shape[d - 1];
+                linear /= m_shape[d - 1];
+            }
+            for (size_type k = first; k != last; ++k)
+            {
+                e.element(index.cbegin(), index.cend()) = element(index.cbegin(), index.cend());
+                for (size_type d = dimension(); d != 0; --d)
+                {
+                    if (++index[d - 1] != m_shape[d - 1])
+                    {
+                        break;
+                    }
+                    index[d - 1] = 0;
+                }
+            }
+        });
+        return true;
+    }
+
+    /**
+     * Reduces blocks of \c block_size consecutive elements, then combines
+     * the partial results pairwise. The shape of the tree only depends on
+     * \c reduced_size and \c block_size. Blocks are reduced in parallel
+     * when the reduced expression can be read concurrently.
+     */
+    template <class F, class CT, class X>
+    inline auto xreducer<F, CT, X>::tree_reduce(const index_type& index, size_type reduced_size, size_type block_size) const -> value_type
+    {
+        using iter_type = detail::reducing_iterator<F, CT, X>;
+        size_type nb_blocks = (reduced_size + block_size - 1) / block_size;
+        uvector<value_type> partials(nb_blocks);
+        auto reduce_blocks = [&](std::size_t first, std::size_t last) {
+            index_type block_index = index;
+            for (size_type b = first; b != last; ++b)
+            {
+                // Unravels the start of the block over the reduced axes
+                size_type linear = b * block_size;
+                for (size_type i = m_axes.size(); i != 0; --i)
+                {
+                    size_type extent = m_e.shape()[m_axes[i - 1]];
+                    block_index[m_axes[i - 1]] = linear % extent;
+                    linear /= extent;
+                }
+                iter_type iter = iter_type(*this, block_index);
+                value_type res = *iter;
+                size_type length = std::min(block_size, reduced_size - b * block_size);
+                for (size_type k = 1; k != length; ++k)
+                {
+                    ++iter;
+                    res = m_f(res, *iter);
+                }
+                partials[b] = res;
+            }
+        };
+        if (is_concurrently_readable<xexpression_type>::value && detail::use_parallel(reduced_size))
+        {
+            size_type grain = std::max(size_type(1), execution_options::execution_options().grain_size / block_size);
+            parallel_for(0, nb_blocks, grain, reduce_blocks);
+        }
+        else
+        {
+            reduce_blocks(0, nb_blocks);
+        }
+        for (size_type width = 1; width < nb_blocks; width *= 2)
+        {
+            for (size_type i = 0; i + width < nb_blocks; i += 2 * width)
+            {
+                partials[i] = m_f(partials[i], partials[i + width]);
+            }
+        }
+        return partials[0];
+    }
 }
 
 #endif
@@ -31,6 +31,14 @@ namespace xt
     template <bool is_const, class CT>
     class xscalar_iterator;
 
+    template <class CT>
+    class xscalar;
+
+    template <class CT>
+    struct is_concurrently_readable<xscalar<CT>> : std::true_type
+    {
+    };
+
     template <class CT>
     class xscalar : public xexpression<xscalar<CT>>
     {
@@ -10,6 +10,7 @@
 #define XSEMANTIC_HPP
 
 #include <functional>
+#include <type_traits>
 #include <utility>
 
 #include "xassign.hpp"
@@ -91,6 +92,14 @@ namespace xt
 
         template <class E>
         derived_type& operator=(const xexpression<E>&);
+
+    private:
+
+        template <class E>
+        derived_type& assign_impl(const xexpression<E>&, std::true_type);
+
+        template <class E>
+        derived_type& assign_impl(const xexpression<E>&, std::false_type);
     };
 
 
@@ -412,6 +421,21 @@ namespace xt
     template <class D>
     template <class E>
     inline auto xsemantic_base<D>::operator=(const xexpression<E>& e) -> derived_type&
+    {
+        return assign_impl(e, is_cheap_expression<E>());
+    }
+
+    // Cheap expressions cannot alias *this
+    template <class D>
+    template <class E>
+    inline auto xsemantic_base<D>::assign_impl(const xexpression<E>& e, std::true_type) -> derived_type&
+    {
+        return this->derived_cast().assign_xexpression(e);
+    }
+
+    template <class D>
+    template <class E>
+    inline auto xsemantic_base<D>::assign_impl(const xexpression<E>& e, std::false_type) -> derived_type&
     {
         temporary_type tmp(e);
         return this->derived_cast().assign_temporary(tmp);
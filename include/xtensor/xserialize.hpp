@@ -0,0 +1,332 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XSERIALIZE_HPP
+#define XSERIALIZE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "xarray.hpp"
+#include "xcontainer.hpp"
+#include "xmissing.hpp"
+#include "xutils.hpp"
+
+namespace xt
+{
+
+    /******************************************
+     * serialize and deserialize declarations *
+     ******************************************/
+
+    template <class D, layout L>
+    void serialize(std::ostream& stream, const xstrided_container<D, L>& c);
+
+    template <class D, layout L>
+    void deserialize(std::istream& stream, xstrided_container<D, L>& c);
+
+    template <class C>
+    C deserialize(std::istream& stream);
+
+    /********************************************
+     * serialize and deserialize implementation *
+     ********************************************/
+
+    namespace detail
+    {
+        constexpr char serialize_magic[4] = {'X', 'T', 'S', 'R'};
+        constexpr char serialize_version = 1;
+
+        inline bool is_little_endian() noexcept
+        {
+            const std::uint16_t probe = 1;
+            char first;
+            std::memcpy(&first, &probe, 1);
+            return first == 1;
+        }
+
+        inline void write_uint64(std::ostream& out, std::uint64_t value)
+        {
+            char buf[8];
+            for (std::size_t i = 0; i < 8; ++i)
+            {
+                buf[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+            }
+            out.write(buf, 8);
+        }
+
+        inline std::uint64_t read_uint64(std::istream& in)
+        {
+            unsigned char buf[8] = {0};
+            in.read(reinterpret_cast<char*>(buf), 8);
+            std::uint64_t value = 0;
+            for (std::size_t i = 0; i < 8; ++i)
+            {
+                value |= std::uint64_t(buf[i]) << (8 * i);
+            }
+            return value;
+        }
+
+        inline char read_byte(std::istream& in)
+        {
+            char c = 0;
+            in.get(c);
+            return c;
+        }
+
+        inline void check_stream(const std::istream& in)
+        {
+            if (!in)
+            {
+                throw std::runtime_error("Unexpected end of serialized stream");
+            }
+        }
+
+        // Reverses the bytes of each scalar of a buffer holding n values of
+        // the given size; complex values are swapped component-wise.
+        inline void swap_bytes(char* buf, std::size_t n, std::size_t size) noexcept
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                std::reverse(buf + i * size, buf + (i + 1) * size);
+            }
+        }
+
+        template <class C>
+        struct serialize_storage
+        {
+            using value_type = typename C::value_type;
+            static constexpr bool is_optional = false;
+
+            static_assert(std::is_trivially_copyable<value_type>::value, "serialized value type must be trivially copyable");
+
+            static void write(std::ostream& out, const C& storage)
+            {
+                out.write(reinterpret_cast<const char*>(storage.data()),
+                          static_cast<std::streamsize>(storage.size() * sizeof(value_type)));
+            }
+
+            static void read(std::istream& in, C& storage, bool swap)
+            {
+                char* buf = reinterpret_cast<char*>(storage.data());
+                in.read(buf, static_cast<std::streamsize>(storage.size() * sizeof(value_type)));
+                check_stream(in);
+                if (swap)
+                {
+                    std::size_t scalar_size = is_complex<value_type>::value ? sizeof(value_type) / 2 : sizeof(value_type);
+                    swap_bytes(buf, storage.size() * sizeof(value_type) / scalar_size, scalar_size);
+                }
+            }
+        };
+
+        template <class T, class A, class BA>
+        struct serialize_storage<xoptional_vector<T, A, BA>>
+        {
+            using storage_type = xoptional_vector<T, A, BA>;
+            using value_type = T;
+            static constexpr bool is_optional = true;
+
+            // Values are written as a plain buffer, followed by the flags
+            // packed in bits.
+            static void write(std::ostream& out, const storage_type& storage)
+            {
+                serialize_storage<std::vector<T, A>>::write(out, storage.value());
+                const auto& flags = storage.has_value();
+                std::vector<char> packed((flags.size() + 7) / 8, 0);
+                for (std::size_t i = 0; i < flags.size(); ++i)
+                {
+                    if (flags[i])
+                    {
+                        packed[i / 8] = static_cast<char>(packed[i / 8] | (1 << (i % 8)));
+                    }
+                }
+                out.write(packed.data(), static_cast<std::streamsize>(packed.size()));
+            }
+
+            static void read(std::istream& in, storage_type& storage, bool swap)
+            {
+                serialize_storage<std::vector<T, A>>::read(in, storage.value(), swap);
+                auto& flags = storage.has_value();
+                std::vector<char> packed((flags.size() + 7) / 8);
+                in.read(packed.data(), static_cast<std::streamsize>(packed.size()));
+                check_stream(in);
+                for (std::size_t i = 0; i < flags.size(); ++i)
+                {
+                    flags[i] = (packed[i / 8] >> (i % 8)) & 1;
+                }
+            }
+        };
+
+        template <class S>
+        inline void read_sequence(std::istream& in, S& s, std::size_t dim)
+        {
+            if (!resize_container(s, dim))
+            {
+                throw std::runtime_error("Serialized dimension " + std::to_string(dim) + " does not match the container");
+            }
+            for (auto& v : s)
+            {
+                v = static_cast<typename S::value_type>(read_uint64(in));
+            }
+        }
+
+        template <class C>
+        inline void read_storage(std::istream& in, C& c, bool swap)
+        {
+            std::uint64_t count = read_uint64(in);
+            check_stream(in);
+            if (count != c.data().size())
+            {
+                throw std::runtime_error("Serialized data size does not match its shape");
+            }
+            serialize_storage<typename C::container_type>::read(in, c.data(), swap);
+        }
+    }
+
+    /**
+     * @brief Binary serialization of a container.
+     *
+     * Writes the container \c c to \c stream: a small header holding the value
+     * type, the layout, the shape and the strides, followed by the raw data
+     * written in a single call. The stream is written sequentially, so that
+     * any output stream (file, string, pipe) can be used.
+     * @param stream the output stream
+     * @param c the xarray_container or xtensor_container to serialize
+     * @sa deserialize
+     */
+    template <class D, layout L>
+    inline void serialize(std::ostream& stream, const xstrided_container<D, L>& c)
+    {
+        using storage_type = detail::serialize_storage<typename D::container_type>;
+        using value_type = typename storage_type::value_type;
+
+        stream.write(detail::serialize_magic, sizeof(detail::serialize_magic));
+        stream.put(detail::serialize_version);
+        stream.put(detail::is_little_endian() ? 'L' : 'B');
+        stream.put(dtype_kind<value_type>());
+        stream.put(static_cast<char>(sizeof(value_type)));
+        stream.put(storage_type::is_optional ? 1 : 0);
+        stream.put(static_cast<char>(c.layout()));
+
+        detail::write_uint64(stream, c.dimension());
+        for (auto s : c.shape())
+        {
+            detail::write_uint64(stream, s);
+        }
+        for (auto s : c.strides())
+        {
+            detail::write_uint64(stream, s);
+        }
+        detail::write_uint64(stream, c.data().size());
+        storage_type::write(stream, c.data());
+        if (!stream)
+        {
+            throw std::runtime_error("Failed to serialize container");
+        }
+    }
+
+    /**
+     * @brief Binary deserialization of a container.
+     *
+     * Reads a container written by serialize from \c stream into \c c, which
+     * is reshaped accordingly. The value type must match the serialized one.
+     * If the serialized layout differs from the static layout of \c c, the
+     * data is transposed on the fly. Data written on a machine of different
+     * endianness is byte swapped.
+     * @param stream the input stream
+     * @param c the xarray_container or xtensor_container to fill
+     * @sa serialize
+     */
+    template <class D, layout L>
+    inline void deserialize(std::istream& stream, xstrided_container<D, L>& c)
+    {
+        using container_type = typename D::container_type;
+        using storage_type = detail::serialize_storage<container_type>;
+        using value_type = typename storage_type::value_type;
+
+        char magic[sizeof(detail::serialize_magic)] = {0};
+        stream.read(magic, sizeof(magic));
+        detail::check_stream(stream);
+        if (!std::equal(magic, magic + sizeof(magic), detail::serialize_magic) ||
+            detail::read_byte(stream) != detail::serialize_version)
+        {
+            throw std::runtime_error("Unsupported serialized container format");
+        }
+        bool swap = (detail::read_byte(stream) == 'L') != detail::is_little_endian();
+        char kind = detail::read_byte(stream);
+        char size = detail::read_byte(stream);
+        bool optional = detail::read_byte(stream) != 0;
+        xt::layout l = static_cast<xt::layout>(static_cast<unsigned char>(detail::read_byte(stream)));
+        detail::check_stream(stream);
+        if (kind != dtype_kind<value_type>() || size != static_cast<char>(sizeof(value_type)) ||
+            optional != storage_type::is_optional)
+        {
+            throw std::runtime_error("Serialized value type does not match the container");
+        }
+
+        std::size_t dim = static_cast<std::size_t>(detail::read_uint64(stream));
+        detail::check_stream(stream);
+        D& dc = static_cast<D&>(c);
+        if (L == xt::layout::dynamic || l == L)
+        {
+            typename D::shape_type shape;
+            typename D::strides_type strides;
+            detail::read_sequence(stream, shape, dim);
+            detail::read_sequence(stream, strides, dim);
+            detail::check_stream(stream);
+            if (l == xt::layout::dynamic)
+            {
+                dc.reshape(shape, strides);
+            }
+            else
+            {
+                dc.reshape(shape, l);
+            }
+            detail::read_storage(stream, dc, swap);
+        }
+        else
+        {
+            using temporary_type = xarray_container<container_type, xt::layout::dynamic, std::vector<std::size_t>>;
+            std::vector<std::size_t> shape;
+            std::vector<std::size_t> strides;
+            detail::read_sequence(stream, shape, dim);
+            detail::read_sequence(stream, strides, dim);
+            detail::check_stream(stream);
+            temporary_type tmp;
+            tmp.reshape(shape, strides);
+            detail::read_storage(stream, tmp, swap);
+            dc = tmp;
+        }
+    }
+
+    /**
+     * @brief Binary deserialization of a container.
+     *
+     * Reads a container of type \c C written by serialize from \c stream.
+     * @param stream the input stream
+     * @return the deserialized container
+     * @tparam C the type of the container to read
+     */
+    template <class C>
+    inline C deserialize(std::istream& stream)
+    {
+        C c;
+        deserialize(stream, c);
+        return c;
+    }
+}
+
+#endif
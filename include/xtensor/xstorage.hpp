@@ -10,11 +10,14 @@
 #define XSTORAGE_HPP
 
 #include <algorithm>
+#include <array>
+#include <cstddef>
 #include <functional>
 #include <initializer_list>
 #include <iterator>
 #include <memory>
 #include <type_traits>
+#include <utility>
 
 // Compiler bug workaround
 #if (__GNUC__ && (__GNUC__ < 5 || (__GNUC__ == 5 && __GNUC_MINOR__ < 1)) ) && !(defined(__APPLE__)) || defined(X_OLD_CLANG)
@@ -147,6 +150,140 @@ namespace xt
     template <class T, class A>
     void swap(uvector<T, A>& lhs, uvector<T, A>& rhs) noexcept;
 
+    /***********************
+     * svector declaration *
+     ***********************/
+
+    /**
+     * @class svector
+     * @brief Vector with a small buffer optimization.
+     *
+     * The svector class holds up to N elements in an inner buffer, and only
+     * allocates memory when it grows beyond that. It is meant for indices and
+     * shapes, whose size is the number of dimensions of an expression, so that
+     * they can be built in hot loops without touching the heap.
+     *
+     * @tparam T the type of the elements, which must be default constructible
+     * @tparam N the number of elements of the inner buffer
+     * @tparam A the allocator used beyond N elements
+     */
+    template <class T, std::size_t N = 4, class Allocator = std::allocator<T>>
+    class svector
+    {
+
+    public:
+
+        using allocator_type = Allocator;
+
+        using value_type = T;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using pointer = value_type*;
+        using const_pointer = const value_type*;
+
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        using iterator = pointer;
+        using const_iterator = const_pointer;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        svector() noexcept;
+        explicit svector(const allocator_type& alloc) noexcept;
+        explicit svector(size_type count, const allocator_type& alloc = allocator_type());
+        svector(size_type count, const_reference value, const allocator_type& alloc = allocator_type());
+
+        template <class InputIt, class = detail::require_input_iter<InputIt>>
+        svector(InputIt first, InputIt last, const allocator_type& alloc = allocator_type());
+
+        svector(std::initializer_list<T> init, const allocator_type& alloc = allocator_type());
+
+        ~svector();
+
+        svector(const svector& rhs);
+        svector& operator=(const svector& rhs);
+
+        svector(svector&& rhs) noexcept(std::is_nothrow_move_constructible<T>::value);
+        svector& operator=(svector&& rhs) noexcept(std::is_nothrow_move_assignable<T>::value);
+
+        allocator_type get_allocator() const noexcept;
+
+        bool empty() const noexcept;
+        size_type size() const noexcept;
+        size_type capacity() const noexcept;
+        bool on_stack() const noexcept;
+
+        void resize(size_type size);
+        void resize(size_type size, const_reference value);
+        void reserve(size_type new_cap);
+        void clear() noexcept;
+
+        void push_back(const_reference value);
+        void pop_back();
+        iterator erase(const_iterator pos);
+
+        reference operator[](size_type i);
+        const_reference operator[](size_type i) const;
+
+        reference front();
+        const_reference front() const;
+
+        reference back();
+        const_reference back() const;
+
+        pointer data() noexcept;
+        const_pointer data() const noexcept;
+
+        iterator begin() noexcept;
+        iterator end() noexcept;
+
+        const_iterator begin() const noexcept;
+        const_iterator end() const noexcept;
+
+        const_iterator cbegin() const noexcept;
+        const_iterator cend() const noexcept;
+
+        reverse_iterator rbegin() noexcept;
+        reverse_iterator rend() noexcept;
+
+        const_reverse_iterator rbegin() const noexcept;
+        const_reverse_iterator rend() const noexcept;
+
+        const_reverse_iterator crbegin() const noexcept;
+        const_reverse_iterator crend() const noexcept;
+
+        void swap(svector& rhs);
+
+    private:
+
+        template <class I>
+        void init_data(I first, I last);
+
+        void grow(size_type min_capacity);
+        void release() noexcept;
+
+        allocator_type m_allocator;
+
+        pointer p_begin;
+        pointer p_end;
+        pointer p_capacity;
+
+        std::array<T, N> m_data;
+    };
+
+    template <class T, std::size_t N, class A>
+    bool operator==(const svector<T, N, A>& lhs, const svector<T, N, A>& rhs);
+
+    template <class T, std::size_t N, class A>
+    bool operator!=(const svector<T, N, A>& lhs, const svector<T, N, A>& rhs);
+
+    template <class T, std::size_t N, class A>
+    bool operator<(const svector<T, N, A>& lhs, const svector<T, N, A>& rhs);
+
+    template <class T, std::size_t N, class A>
+    void swap(svector<T, N, A>& lhs, svector<T, N, A>& rhs);
+
     /**************************
      * uvector implementation *
      **************************/
@@ -535,6 +672,414 @@ namespace xt
     {
         lhs.swap(rhs);
     }
+
+    /**************************
+     * svector implementation *
+     **************************/
+
+    template <class T, std::size_t N, class A>
+    template <class I>
+    inline void svector<T, N, A>::init_data(I first, I last)
+    {
+        size_type size = static_cast<size_type>(std::distance(first, last));
+        if (size > N)
+        {
+            grow(size);
+        }
+        p_end = std::copy(first, last, p_begin);
+    }
+
+    // Moves the elements to a heap buffer of at least min_capacity elements
+    template <class T, std::size_t N, class A>
+    inline void svector<T, N, A>::grow(size_type min_capacity)
+    {
+        size_type new_cap = std::max(min_capacity, 2 * capacity());
+        pointer new_begin = detail::safe_init_allocate(m_allocator, new_cap);
+        pointer new_end = std::move(p_begin, p_end, new_begin);
+        release();
+        p_begin = new_begin;
+        p_end = new_end;
+        p_capacity = new_begin + new_cap;
+    }
+
+    template <class T, std::size_t N, class A>
+    inline void svector<T, N, A>::release() noexcept
+    {
+        if (!on_stack())
+        {
+            detail::safe_destroy_deallocate(m_allocator, p_begin, capacity());
+        }
+        p_begin = m_data.data();
+        p_end = p_begin;
+        p_capacity = p_begin + N;
+    }
+
+    template <class T, std::size_t N, class A>
+    inline svector<T, N, A>::svector() noexcept
+        : svector(allocator_type())
+    {
+    }
+
+    template <class T, std::size_t N, class A>
+    inline svector<T, N, A>::svector(const allocator_type& alloc) noexcept
+        : m_allocator(alloc)
+    {
+        p_begin = m_data.data();
+        p_end = p_begin;
+        p_capacity = p_begin + N;
+    }
+
+    template <class T, std::size_t N, class A>
+    inline svector<T, N, A>::svector(size_type count, const allocator_type& alloc)
+        : svector(alloc)
+    {
+        resize(count);
+    }
+
+    template <class T, std::size_t N, class A>
+    inline svector<T, N, A>::svector(size_type count, const_reference value, const allocator_type& alloc)
+        : svector(alloc)
+    {
+        resize(count, value);
+    }
+
+    template <class T, std::size_t N, class A>
+    template <class InputIt, class>
+    inline svector<T, N, A>::svector(InputIt first, InputIt last, const allocator_type& alloc)
+        : svector(alloc)
+    {
+        init_data(first, last);
+    }
+
+    template <class T, std::size_t N, class A>
+    inline svector<T, N, A>::svector(std::initializer_list<T> init, const allocator_type& alloc)
+        : svector(alloc)
+    {
+        init_data(init.begin(), init.end());
+    }
+
+    template <class T, std::size_t N, class A>
+    inline svector<T, N, A>::~svector()
+    {
+        release();
+    }
+
+    template <class T, std::size_t N, class A>
+    inline svector<T, N, A>::svector(const svector& rhs)
+        : svector(std::allocator_traits<allocator_type>::select_on_container_copy_construction(rhs.get_allocator()))
+    {
+        init_data(rhs.p_begin, rhs.p_end);
+    }
+
+    template <class T, std::size_t N, class A>
+    inline svector<T, N, A>& svector<T, N, A>::operator=(const svector& rhs)
+    {
+        if (this != &rhs)
+        {
+            if (rhs.size() > capacity())
+            {
+                release();
+                grow(rhs.size());
+            }
+            p_end = std::copy(rhs.p_begin, rhs.p_end, p_begin);
+        }
+        return *this;
+    }
+
+    template <class T, std::size_t N, class A>
+    inline svector<T, N, A>::svector(svector&& rhs) noexcept(std::is_nothrow_move_constructible<T>::value)
+        : svector(rhs.get_allocator())
+    {
+        if (rhs.on_stack())
+        {
+            p_end = std::move(rhs.p_begin, rhs.p_end, p_begin);
+            rhs.p_end = rhs.p_begin;
+        }
+        else
+        {
+            p_begin = rhs.p_begin;
+            p_end = rhs.p_end;
+            p_capacity = rhs.p_capacity;
+            rhs.p_begin = rhs.m_data.data();
+            rhs.p_end = rhs.p_begin;
+            rhs.p_capacity = rhs.p_begin + N;
+        }
+    }
+
+    template <class T, std::size_t N, class A>
+    inline svector<T, N, A>& svector<T, N, A>::operator=(svector&& rhs) noexcept(std::is_nothrow_move_assignable<T>::value)
+    {
+        if (this != &rhs)
+        {
+            if (rhs.on_stack())
+            {
+                p_end = std::move(rhs.p_begin, rhs.p_end, p_begin);
+            }
+            else
+            {
+                release();
+                p_begin = rhs.p_begin;
+                p_end = rhs.p_end;
+                p_capacity = rhs.p_capacity;
+                rhs.p_begin = rhs.m_data.data();
+                rhs.p_capacity = rhs.p_begin + N;
+            }
+            rhs.p_end = rhs.p_begin;
+        }
+        return *this;
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::get_allocator() const noexcept -> allocator_type
+    {
+        return allocator_type(m_allocator);
+    }
+
+    template <class T, std::size_t N, class A>
+    inline bool svector<T, N, A>::empty() const noexcept
+    {
+        return p_begin == p_end;
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::size() const noexcept -> size_type
+    {
+        return static_cast<size_type>(p_end - p_begin);
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::capacity() const noexcept -> size_type
+    {
+        return static_cast<size_type>(p_capacity - p_begin);
+    }
+
+    /**
+     * Returns true if the elements are stored in the inner buffer.
+     */
+    template <class T, std::size_t N, class A>
+    inline bool svector<T, N, A>::on_stack() const noexcept
+    {
+        return p_begin == m_data.data();
+    }
+
+    template <class T, std::size_t N, class A>
+    inline void svector<T, N, A>::resize(size_type size)
+    {
+        resize(size, value_type());
+    }
+
+    template <class T, std::size_t N, class A>
+    inline void svector<T, N, A>::resize(size_type size, const_reference value)
+    {
+        if (size > capacity())
+        {
+            grow(size);
+        }
+        if (size > this->size())
+        {
+            std::fill(p_end, p_begin + size, value);
+        }
+        p_end = p_begin + size;
+    }
+
+    template <class T, std::size_t N, class A>
+    inline void svector<T, N, A>::reserve(size_type new_cap)
+    {
+        if (new_cap > capacity())
+        {
+            grow(new_cap);
+        }
+    }
+
+    template <class T, std::size_t N, class A>
+    inline void svector<T, N, A>::clear() noexcept
+    {
+        p_end = p_begin;
+    }
+
+    template <class T, std::size_t N, class A>
+    inline void svector<T, N, A>::push_back(const_reference value)
+    {
+        if (p_end == p_capacity)
+        {
+            value_type tmp = value;
+            grow(size() + 1);
+            *p_end++ = std::move(tmp);
+        }
+        else
+        {
+            *p_end++ = value;
+        }
+    }
+
+    template <class T, std::size_t N, class A>
+    inline void svector<T, N, A>::pop_back()
+    {
+        --p_end;
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::erase(const_iterator pos) -> iterator
+    {
+        iterator it = p_begin + (pos - p_begin);
+        std::move(it + 1, p_end, it);
+        --p_end;
+        return it;
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::operator[](size_type i) -> reference
+    {
+        return p_begin[i];
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::operator[](size_type i) const -> const_reference
+    {
+        return p_begin[i];
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::front() -> reference
+    {
+        return p_begin[0];
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::front() const -> const_reference
+    {
+        return p_begin[0];
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::back() -> reference
+    {
+        return *(p_end - 1);
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::back() const -> const_reference
+    {
+        return *(p_end - 1);
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::data() noexcept -> pointer
+    {
+        return p_begin;
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::data() const noexcept -> const_pointer
+    {
+        return p_begin;
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::begin() noexcept -> iterator
+    {
+        return p_begin;
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::end() noexcept -> iterator
+    {
+        return p_end;
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::begin() const noexcept -> const_iterator
+    {
+        return p_begin;
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::end() const noexcept -> const_iterator
+    {
+        return p_end;
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::cbegin() const noexcept -> const_iterator
+    {
+        return begin();
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::cend() const noexcept -> const_iterator
+    {
+        return end();
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::rbegin() noexcept -> reverse_iterator
+    {
+        return reverse_iterator(end());
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::rend() noexcept -> reverse_iterator
+    {
+        return reverse_iterator(begin());
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::rbegin() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator(end());
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::rend() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::crbegin() const noexcept -> const_reverse_iterator
+    {
+        return rbegin();
+    }
+
+    template <class T, std::size_t N, class A>
+    inline auto svector<T, N, A>::crend() const noexcept -> const_reverse_iterator
+    {
+        return rend();
+    }
+
+    template <class T, std::size_t N, class A>
+    inline void svector<T, N, A>::swap(svector& rhs)
+    {
+        svector tmp(std::move(rhs));
+        rhs = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    template <class T, std::size_t N, class A>
+    inline bool operator==(const svector<T, N, A>& lhs, const svector<T, N, A>& rhs)
+    {
+        return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    template <class T, std::size_t N, class A>
+    inline bool operator!=(const svector<T, N, A>& lhs, const svector<T, N, A>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    template <class T, std::size_t N, class A>
+    inline bool operator<(const svector<T, N, A>& lhs, const svector<T, N, A>& rhs)
+    {
+        return std::lexicographical_compare(lhs.begin(), lhs.end(),
+                                            rhs.begin(), rhs.end(),
+                                            std::less<T>());
+    }
+
+    template <class T, std::size_t N, class A>
+    inline void swap(svector<T, N, A>& lhs, svector<T, N, A>& rhs)
+    {
+        lhs.swap(rhs);
+    }
 }
 
 #endif
@@ -0,0 +1,1385 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XSTRIDED_VIEW_HPP
+#define XSTRIDED_VIEW_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "xbroadcast.hpp"
+#include "xcontainer.hpp"
+#include "xexecution.hpp"
+#include "xgenerator.hpp"
+#include "xiterable.hpp"
+#include "xsemantic.hpp"
+#include "xstrides.hpp"
+#include "xutils.hpp"
+#include "xview_utils.hpp"
+
+namespace xt
+{
+
+    /*****************************
+     * xstrided_view declaration *
+     *****************************/
+
+    template <class CT, class S = typename std::decay_t<CT>::shape_type>
+    class xstrided_view;
+
+    template <bool is_const, class CT, class S>
+    class xstrided_view_stepper;
+
+    template <class CT, class S>
+    struct xcontainer_inner_types<xstrided_view<CT, S>>
+    {
+        using xexpression_type = std::decay_t<CT>;
+        using temporary_type = typename detail::view_temporary_type_impl<typename xexpression_type::value_type,
+                                                                          S, xexpression_type::layout_type>::type;
+    };
+
+    template <class CT, class S>
+    struct xiterable_inner_types<xstrided_view<CT, S>>
+    {
+        using xexpression_type = std::decay_t<CT>;
+        using inner_shape_type = S;
+        using stepper = xstrided_view_stepper<false, CT, S>;
+        using const_stepper = xstrided_view_stepper<true, CT, S>;
+        using broadcast_iterator = xiterator<stepper, inner_shape_type*>;
+        using const_broadcast_iterator = xiterator<const_stepper, inner_shape_type*>;
+        using iterator = broadcast_iterator;
+        using const_iterator = const_broadcast_iterator;
+    };
+
+    template <class CT, class S>
+    struct is_concurrently_readable<xstrided_view<CT, S>>
+        : is_concurrently_readable<std::decay_t<CT>>
+    {
+    };
+
+    /**
+     * @class xstrided_view
+     * @brief View of a container described by a shape, signed strides and an offset.
+     *
+     * The xstrided_view class addresses the elements of the buffer of a container
+     * through its own shape and strides. Strides may be negative, so that a dimension
+     * can be traversed backward without any index computation. Accessing an element
+     * of the view costs a single memory read, and its stepper moves a pointer.
+     * xstrided_view is not meant to be used directly, but through helper functions
+     * such as \ref strided_view or \ref flip, or by slicing a view with \ref view.
+     *
+     * @tparam CT the closure type of the container to adapt
+     * @tparam S the shape type of the view, which defaults to the one of the container
+     *
+     * @sa strided_view, flip, view
+     */
+    template <class CT, class S>
+    class xstrided_view : public xview_semantic<xstrided_view<CT, S>>,
+                          public xexpression_iterable<xstrided_view<CT, S>>
+    {
+
+    public:
+
+        using self_type = xstrided_view<CT, S>;
+        using xexpression_type = std::decay_t<CT>;
+        using semantic_base = xview_semantic<self_type>;
+
+        static constexpr bool is_const = std::is_const<std::remove_reference_t<CT>>::value;
+
+        using value_type = typename xexpression_type::value_type;
+        using reference = std::conditional_t<is_const,
+                                             typename xexpression_type::const_reference,
+                                             typename xexpression_type::reference>;
+        using const_reference = typename xexpression_type::const_reference;
+        using pointer = std::conditional_t<is_const,
+                                           typename xexpression_type::const_pointer,
+                                           typename xexpression_type::pointer>;
+        using const_pointer = typename xexpression_type::const_pointer;
+        using size_type = typename xexpression_type::size_type;
+        using difference_type = typename xexpression_type::difference_type;
+
+        using iterable_base = xexpression_iterable<self_type>;
+        using inner_shape_type = typename iterable_base::inner_shape_type;
+        using shape_type = inner_shape_type;
+        using strides_type = signed_strides_type_t<shape_type>;
+
+        using stepper = typename iterable_base::stepper;
+        using const_stepper = typename iterable_base::const_stepper;
+
+        using broadcast_iterator = typename iterable_base::broadcast_iterator;
+        using const_broadcast_iterator = typename iterable_base::const_broadcast_iterator;
+
+        using iterator = typename iterable_base::iterator;
+        using const_iterator = typename iterable_base::const_iterator;
+
+        static constexpr xt::layout layout_type = xt::layout::dynamic;
+        static constexpr bool contiguous_layout = false;
+
+        template <class CTA>
+        xstrided_view(CTA&& e, shape_type shape, strides_type strides, size_type offset) noexcept;
+
+        template <class E>
+        self_type& operator=(const xexpression<E>& e);
+
+        template <class E>
+        disable_xexpression<E, self_type>& operator=(const E& e);
+
+        size_type dimension() const noexcept;
+
+        size_type size() const noexcept;
+        const inner_shape_type& shape() const noexcept;
+        const strides_type& strides() const noexcept;
+        const strides_type& backstrides() const noexcept;
+        xt::layout layout() const noexcept;
+
+        xexpression_type& expression() noexcept;
+        const xexpression_type& expression() const noexcept;
+
+        template <class... Args>
+        reference operator()(Args... args);
+        reference operator[](const xindex& index);
+        reference operator[](size_type i);
+        template <class It>
+        reference element(It first, It last);
+
+        template <class... Args>
+        const_reference operator()(Args... args) const;
+        const_reference operator[](const xindex& index) const;
+        const_reference operator[](size_type i) const;
+        template <class It>
+        const_reference element(It first, It last) const;
+
+        template <class ST>
+        bool broadcast_shape(ST& shape) const;
+
+        template <class ST>
+        bool is_trivial_broadcast(const ST& strides) const;
+
+        template <class ST>
+        stepper stepper_begin(const ST& shape);
+        template <class ST>
+        stepper stepper_end(const ST& shape);
+
+        template <class ST>
+        const_stepper stepper_begin(const ST& shape) const;
+        template <class ST>
+        const_stepper stepper_end(const ST& shape) const;
+
+        template <class E>
+        bool assign_to(E& e) const;
+
+        const typename xexpression_type::container_type& data() const;
+        pointer raw_data();
+        const_pointer raw_data() const;
+        size_type raw_data_offset() const noexcept;
+
+    private:
+
+        CT m_e;
+        shape_type m_shape;
+        strides_type m_strides;
+        strides_type m_backstrides;
+        size_type m_offset;
+
+        template <class... Args>
+        difference_type data_offset(Args... args) const noexcept;
+
+        template <class It>
+        difference_type element_offset(It first, It last) const noexcept;
+
+        difference_type end_offset() const noexcept;
+
+        pointer data_xbegin();
+        const_pointer data_xbegin() const;
+
+        using temporary_type = typename xcontainer_inner_types<self_type>::temporary_type;
+        void assign_temporary_impl(temporary_type& tmp);
+
+        friend class xview_semantic<self_type>;
+        friend class xstrided_view_stepper<true, CT, S>;
+        friend class xstrided_view_stepper<false, CT, S>;
+    };
+
+    template <class E, class SH, class ST>
+    auto strided_view(E&& e, SH&& shape, ST&& strides, std::size_t offset = 0);
+
+    /**************************
+     * transpose and swapaxes *
+     **************************/
+
+    template <class E>
+    auto transpose(E&& e);
+
+    template <class E, class S, class Tag = check_policy::none>
+    auto transpose(E&& e, S&& permutation, Tag check_policy = Tag());
+
+    template <class E, class I, std::size_t N, class Tag = check_policy::none>
+    auto transpose(E&& e, const I (&permutation)[N], Tag check_policy = Tag());
+
+    template <class E>
+    auto swapaxes(E&& e, std::size_t axis1, std::size_t axis2);
+
+    /****************
+     * reshape_view *
+     ****************/
+
+    template <class E, class S>
+    auto reshape_view(E&& e, S&& shape);
+
+    template <class E, class I, std::size_t N>
+    auto reshape_view(E&& e, const I (&shape)[N]);
+
+    namespace detail
+    {
+        // Views holding a reference on a container with a buffer can be
+        // sliced again without nesting: the slices are composed into a
+        // single strided view on the container.
+        template <class E>
+        struct is_collapsible_view : std::false_type
+        {
+        };
+
+        template <class CT, class... S>
+        struct is_collapsible_view<xview<CT, S...>>
+            : std::integral_constant<bool, std::is_lvalue_reference<CT>::value && has_strided_data<xview<CT, S...>>::value>
+        {
+            using closure_type = CT;
+        };
+
+        template <class CT, class S>
+        struct is_collapsible_view<xstrided_view<CT, S>>
+            : std::integral_constant<bool, std::is_lvalue_reference<CT>::value && has_strided_data<xstrided_view<CT, S>>::value>
+        {
+            using closure_type = CT;
+        };
+
+        template <class E>
+        using collapsed_closure_t = std::conditional_t<std::is_const<std::remove_reference_t<E>>::value ||
+                                                           std::is_const<std::remove_reference_t<typename is_collapsible_view<std::decay_t<E>>::closure_type>>::value,
+                                                       const typename std::decay_t<E>::xexpression_type&,
+                                                       typename std::decay_t<E>::xexpression_type&>;
+
+
+        // Container of a collapsible view, with the constness of the
+        // view and of its closure
+        template <class E>
+        inline collapsed_closure_t<E> collapsed_expression(E& e) noexcept
+        {
+            using source_type = std::conditional_t<std::is_const<std::remove_reference_t<collapsed_closure_t<E>>>::value,
+                                                   const std::decay_t<E>&, std::decay_t<E>&>;
+            source_type source = e;
+            return source.expression();
+        }
+    }
+
+    /*************************************
+     * xstrided_view_stepper declaration *
+     *************************************/
+
+    template <bool is_const, class CT, class S>
+    class xstrided_view_stepper
+    {
+
+    public:
+
+        using view_type = std::conditional_t<is_const,
+                                             const xstrided_view<CT, S>,
+                                             xstrided_view<CT, S>>;
+
+        using value_type = typename view_type::value_type;
+        using reference = std::conditional_t<is_const,
+                                             typename view_type::const_reference,
+                                             typename view_type::reference>;
+        using pointer = std::conditional_t<is_const,
+                                           typename view_type::const_pointer,
+                                           typename view_type::pointer>;
+        using difference_type = typename view_type::difference_type;
+        using size_type = typename view_type::size_type;
+        using shape_type = typename view_type::shape_type;
+
+        xstrided_view_stepper() = default;
+        xstrided_view_stepper(view_type* view, pointer it, size_type offset) noexcept;
+
+        reference operator*() const;
+
+        void step(size_type dim, size_type n = 1);
+        void step_back(size_type dim, size_type n = 1);
+        void reset(size_type dim);
+
+        void to_end();
+
+        bool equal(const xstrided_view_stepper& rhs) const;
+
+    private:
+
+        view_type* p_view;
+        pointer m_it;
+        size_type m_offset;
+    };
+
+    template <bool is_const, class CT, class S>
+    bool operator==(const xstrided_view_stepper<is_const, CT, S>& lhs,
+                    const xstrided_view_stepper<is_const, CT, S>& rhs);
+
+    template <bool is_const, class CT, class S>
+    bool operator!=(const xstrided_view_stepper<is_const, CT, S>& lhs,
+                    const xstrided_view_stepper<is_const, CT, S>& rhs);
+
+    /********************************
+     * xstrided_view implementation *
+     ********************************/
+
+    /**
+     * @name Constructor
+     */
+    //@{
+    /**
+     * Constructs a strided view on the specified container.
+     * Users should not call directly this constructor but
+     * use the strided_view function instead.
+     * @param e the container to adapt
+     * @param shape the shape of the view
+     * @param strides the strides of the view, possibly negative
+     * @param offset the position of the first element of the view
+     * in the buffer of the container
+     * @sa strided_view
+     */
+    template <class CT, class S>
+    template <class CTA>
+    inline xstrided_view<CT, S>::xstrided_view(CTA&& e, shape_type shape, strides_type strides, size_type offset) noexcept
+        : m_e(std::forward<CTA>(e)), m_shape(std::move(shape)), m_strides(std::move(strides)),
+          m_backstrides(make_sequence<strides_type>(m_shape.size(), 0)), m_offset(offset)
+    {
+        for (size_type i = 0; i < m_shape.size(); ++i)
+        {
+            if (m_shape[i] == 1)
+            {
+                m_strides[i] = 0;
+            }
+            m_backstrides[i] = m_strides[i] * (static_cast<difference_type>(m_shape[i]) - 1);
+        }
+    }
+    //@}
+
+    /**
+     * @name Extended copy semantic
+     */
+    //@{
+    /**
+     * The extended assignment operator.
+     */
+    template <class CT, class S>
+    template <class E>
+    inline auto xstrided_view<CT, S>::operator=(const xexpression<E>& e) -> self_type&
+    {
+        bool cond = (e.derived_cast().shape().size() == dimension()) &&
+                    std::equal(shape().begin(), shape().end(), e.derived_cast().shape().begin());
+        if (!cond)
+        {
+            semantic_base::operator=(broadcast(e.derived_cast(), shape()));
+        }
+        else
+        {
+            semantic_base::operator=(e);
+        }
+        return *this;
+    }
+    //@}
+
+    template <class CT, class S>
+    template <class E>
+    inline auto xstrided_view<CT, S>::operator=(const E& e) -> disable_xexpression<E, self_type>&
+    {
+        std::fill(this->begin(), this->end(), e);
+        return *this;
+    }
+
+    /**
+     * @name Size and shape
+     */
+    //@{
+    /**
+     * Returns the number of dimensions of the view.
+     */
+    template <class CT, class S>
+    inline auto xstrided_view<CT, S>::dimension() const noexcept -> size_type
+    {
+        return m_shape.size();
+    }
+
+    /**
+     * Returns the size of the view.
+     */
+    template <class CT, class S>
+    inline auto xstrided_view<CT, S>::size() const noexcept -> size_type
+    {
+        return compute_size(shape());
+    }
+
+    /**
+     * Returns the shape of the view.
+     */
+    template <class CT, class S>
+    inline auto xstrided_view<CT, S>::shape() const noexcept -> const inner_shape_type&
+    {
+        return m_shape;
+    }
+
+    /**
+     * Returns the strides of the view, in number of elements
+     * of the underlying buffer.
+     */
+    template <class CT, class S>
+    inline auto xstrided_view<CT, S>::strides() const noexcept -> const strides_type&
+    {
+        return m_strides;
+    }
+
+    /**
+     * Returns the backstrides of the view.
+     */
+    template <class CT, class S>
+    inline auto xstrided_view<CT, S>::backstrides() const noexcept -> const strides_type&
+    {
+        return m_backstrides;
+    }
+
+    /**
+     * Returns the layout of the view.
+     */
+    template <class CT, class S>
+    inline xt::layout xstrided_view<CT, S>::layout() const noexcept
+    {
+        return layout_type;
+    }
+
+    /**
+     * Returns a reference to the underlying container of the view.
+     */
+    template <class CT, class S>
+    inline auto xstrided_view<CT, S>::expression() noexcept -> xexpression_type&
+    {
+        return m_e;
+    }
+
+    /**
+     * Returns a constant reference to the underlying container of the view.
+     */
+    template <class CT, class S>
+    inline auto xstrided_view<CT, S>::expression() const noexcept -> const xexpression_type&
+    {
+        return m_e;
+    }
+    //@}
+
+    /**
+     * @name Data
+     */
+    //@{
+    /**
+     * Returns a reference to the element at the specified position in the view.
+     * @param args a list of indices specifying the position in the view. Indices
+     * must be unsigned integers, the number of indices should be equal or greater
+     * than the number of dimensions of the view.
+     */
+    template <class CT, class S>
+    template <class... Args>
+    inline auto xstrided_view<CT, S>::operator()(Args... args) -> reference
+    {
+        return data_xbegin()[data_offset(args...)];
+    }
+
+    template <class CT, class S>
+    inline auto xstrided_view<CT, S>::operator[](const xindex& index) -> reference
+    {
+        return element(index.cbegin(), index.cend());
+    }
+
+    template <class CT, class S>
+    inline auto xstrided_view<CT, S>::operator[](size_type i) -> reference
+    {
+        return operator()(i);
+    }
+
+    /**
+     * Returns a reference to the element at the specified position in the view.
+     * @param first iterator starting the sequence of indices
+     * @param last iterator ending the sequence of indices
+     */
+    template <class CT, class S>
+    template <class It>
+    inline auto xstrided_view<CT, S>::element(It first, It last) -> reference
+    {
+        return data_xbegin()[element_offset(first, last)];
+    }
+
+    /**
+     * Returns a constant reference to the element at the specified position in the view.
+     * @param args a list of indices specifying the position in the view. Indices
+     * must be unsigned integers, the number of indices should be equal or greater
+     * than the number of dimensions of the view.
+     */
+    template <class CT, class S>
+    template <class... Args>
+    inline auto xstrided_view<CT, S>::operator()(Args... args) const -> const_reference
+    {
+        return data_xbegin()[data_offset(args...)];
+    }
+
+    template <class CT, class S>
+    inline auto xstrided_view<CT, S>::operator[](const xindex& index) const -> const_reference
+    {
+        return element(index.cbegin(), index.cend());
+    }
+
+    template <class CT, class S>
+    inline auto xstrided_view<CT, S>::operator[](size_type i) const -> const_reference
+    {
+        return operator()(i);
+    }
+
+    /**
+     * Returns a constant reference to the element at the specified position in the view.
+     * @param first iterator starting the sequence of indices
+     * @param last iterator ending the sequence of indices
+     */
+    template <class CT, class S>
+    template <class It>
+    inline auto xstrided_view<CT, S>::element(It first, It last) const -> const_reference
+    {
+        return data_xbegin()[element_offset(first, last)];
+    }
+
+    /**
+     * Returns the storage of the underlying container.
+     */
+    template <class CT, class S>
+    inline auto xstrided_view<CT, S>::data() const -> const typename xexpression_type::container_type&
+    {
+        const xexpression_type& e = m_e;
+        return e.data();
+    }
+
+    /**
+     * Returns a pointer to the buffer of the underlying container.
+     */
+    template <class CT, class S>
+    inline auto xstrided_view<CT, S>::raw_data() -> pointer
+    {
+        return m_e.raw_data();
+    }
+
+    template <class CT, class S>
+    inline auto xstrided_view<CT, S>::raw_data() const -> const_pointer
+    {
+        const xexpression_type& e = m_e;
+        return e.raw_data();
+    }
+
+    /**
+     * Returns the offset of the first element of the view in the
+     * buffer of the underlying container.
+     */
+    template <class CT, class S>
+    inline auto xstrided_view<CT, S>::raw_data_offset() const noexcept -> size_type
+    {
+        return m_e.raw_data_offset() + m_offset;
+    }
+    //@}
+
+    /**
+     * @name Broadcasting
+     */
+    //@{
+    /**
+     * Broadcast the shape of the view to the specified parameter.
+     * @param shape the result shape
+     * @return a boolean indicating whether the broadcasting is trivial
+     */
+    template <class CT, class S>
+    template <class ST>
+    inline bool xstrided_view<CT, S>::broadcast_shape(ST& shape) const
+    {
+        return xt::broadcast_shape(m_shape, shape);
+    }
+
+    /**
+     * Compares the specified strides with those of the view to see whether
+     * the broadcasting is trivial, that is whether they are equal and walk
+     * the elements of the view contiguously in row-major order.
+     * @return a boolean indicating whether the broadcasting is trivial
+     */
+    template <class CT, class S>
+    template <class ST>
+    inline bool xstrided_view<CT, S>::is_trivial_broadcast(const ST& strides) const
+    {
+        auto equal_stride = [](const auto& lhs, const auto& rhs) { return static_cast<difference_type>(lhs) == rhs; };
+        return strides.size() == m_strides.size() &&
+            std::equal(strides.cbegin(), strides.cend(), m_strides.cbegin(), equal_stride) &&
+            has_row_major_strides(m_shape, m_strides);
+    }
+    //@}
+
+    /**
+     * Assigns the view to the row-major container \c e with the same shape.
+     * When the last dimension is contiguous, forward or backward, the rows
+     * are copied in bulk; otherwise the regular assignment loop is used.
+     * @return a boolean indicating whether the view has been assigned
+     */
+    template <class CT, class S>
+    template <class E>
+    inline bool xstrided_view<CT, S>::assign_to(E& e) const
+    {
+        auto* data = detail::linear_storage(e, m_shape);
+        if (data == nullptr || dimension() == 0)
+        {
+            return false;
+        }
+        size_type inner_size = m_shape.back();
+        difference_type inner_stride = m_strides.back();
+        if (inner_size > 1 && inner_stride != 1 && inner_stride != -1)
+        {
+            return false;
+        }
+        size_type nb_rows = inner_size == 0 ? size_type(0) : size() / inner_size;
+        const_pointer base = data_xbegin();
+        auto copy_rows = [this, data, base, inner_size, inner_stride](std::size_t first, std::size_t last) {
+            for (std::size_t r = first; r < last; ++r)
+            {
+                difference_type offset = 0;
+                size_type index = r;
+                for (size_type d = dimension() - 1; d != 0; --d)
+                {
+                    offset += static_cast<difference_type>(index % m_shape[d - 1]) * m_strides[d - 1];
+                    index /= m_shape[d - 1];
+                }
+                const_pointer row = base + offset;
+                if (inner_stride >= 0)
+                {
+                    std::copy(row, row + inner_size, data + r * inner_size);
+                }
+                else
+                {
+                    std::reverse_copy(row - (inner_size - 1), row + 1, data + r * inner_size);
+                }
+            }
+        };
+        if (detail::use_parallel(size()))
+        {
+            size_type grain = std::max(size_type(1), execution_options::execution_options().grain_size / std::max(inner_size, size_type(1)));
+            parallel_for(0, nb_rows, grain, copy_rows);
+        }
+        else
+        {
+            copy_rows(0, nb_rows);
+        }
+        return true;
+    }
+
+    template <class CT, class S>
+    template <class... Args>
+    inline auto xstrided_view<CT, S>::data_offset(Args... args) const noexcept -> difference_type
+    {
+        return xt::data_offset<difference_type>(m_strides, static_cast<difference_type>(args)...);
+    }
+
+    template <class CT, class S>
+    template <class It>
+    inline auto xstrided_view<CT, S>::element_offset(It first, It last) const noexcept -> difference_type
+    {
+        auto dst = static_cast<size_type>(std::distance(first, last));
+        It efirst = last - std::min(m_strides.size(), dst);
+        difference_type offset = 0;
+        for (auto st = m_strides.cbegin(); efirst != last; ++efirst, ++st)
+        {
+            offset += static_cast<difference_type>(*efirst) * *st;
+        }
+        return offset;
+    }
+
+    // Offset of the end position: one past the farthest element, which
+    // cannot be reached by a valid position of the view whatever the
+    // signs of the strides
+    template <class CT, class S>
+    inline auto xstrided_view<CT, S>::end_offset() const noexcept -> difference_type
+    {
+        if (size() == 0)
+        {
+            return 0;
+        }
+        auto farthest = [](difference_type acc, difference_type bs) { return bs > 0 ? acc + bs : acc; };
+        return std::accumulate(m_backstrides.cbegin(), m_backstrides.cend(), difference_type(0), farthest) + 1;
+    }
+
+    template <class CT, class S>
+    inline auto xstrided_view<CT, S>::data_xbegin() -> pointer
+    {
+        return raw_data() + raw_data_offset();
+    }
+
+    template <class CT, class S>
+    inline auto xstrided_view<CT, S>::data_xbegin() const -> const_pointer
+    {
+        return raw_data() + raw_data_offset();
+    }
+
+    template <class CT, class S>
+    inline void xstrided_view<CT, S>::assign_temporary_impl(temporary_type& tmp)
+    {
+        if (!detail::strided_assign(*this, tmp))
+        {
+            std::copy(tmp.cbegin(), tmp.cend(), this->xbegin());
+        }
+    }
+
+    /**
+     * Constructs and returns a strided view on the specified container. The
+     * element at position \c (i0, ..., in) of the view is the element at
+     * position \c offset + \c i0 * strides[0] + ... + \c in * strides[n] in
+     * the buffer of the container.
+     * @param e the container to adapt
+     * @param shape the shape of the view
+     * @param strides the strides of the view, in number of elements, possibly negative
+     * @param offset the position of the first element of the view in the buffer
+     * @sa flip
+     */
+    template <class E, class SH, class ST>
+    inline auto strided_view(E&& e, SH&& shape, ST&& strides, std::size_t offset)
+    {
+        using view_type = xstrided_view<closure_t<E>, std::decay_t<SH>>;
+        using shape_type = typename view_type::shape_type;
+        using strides_type = typename view_type::strides_type;
+        return view_type(std::forward<E>(e), forward_sequence<shape_type>(shape),
+                         forward_sequence<strides_type>(strides), offset);
+    }
+
+    /***************
+     * stepper api *
+     ***************/
+
+    template <class CT, class S>
+    template <class ST>
+    inline auto xstrided_view<CT, S>::stepper_begin(const ST& shape) -> stepper
+    {
+        size_type offset = shape.size() - dimension();
+        return stepper(this, data_xbegin(), offset);
+    }
+
+    template <class CT, class S>
+    template <class ST>
+    inline auto xstrided_view<CT, S>::stepper_end(const ST& shape) -> stepper
+    {
+        size_type offset = shape.size() - dimension();
+        return stepper(this, data_xbegin() + end_offset(), offset);
+    }
+
+    template <class CT, class S>
+    template <class ST>
+    inline auto xstrided_view<CT, S>::stepper_begin(const ST& shape) const -> const_stepper
+    {
+        size_type offset = shape.size() - dimension();
+        return const_stepper(this, data_xbegin(), offset);
+    }
+
+    template <class CT, class S>
+    template <class ST>
+    inline auto xstrided_view<CT, S>::stepper_end(const ST& shape) const -> const_stepper
+    {
+        size_type offset = shape.size() - dimension();
+        return const_stepper(this, data_xbegin() + end_offset(), offset);
+    }
+
+    /****************************************
+     * xstrided_view_stepper implementation *
+     ****************************************/
+
+    template <bool is_const, class CT, class S>
+    inline xstrided_view_stepper<is_const, CT, S>::xstrided_view_stepper(view_type* view, pointer it, size_type offset) noexcept
+        : p_view(view), m_it(it), m_offset(offset)
+    {
+    }
+
+    template <bool is_const, class CT, class S>
+    inline auto xstrided_view_stepper<is_const, CT, S>::operator*() const -> reference
+    {
+        return *m_it;
+    }
+
+    template <bool is_const, class CT, class S>
+    inline void xstrided_view_stepper<is_const, CT, S>::step(size_type dim, size_type n)
+    {
+        if (dim >= m_offset)
+        {
+            m_it += static_cast<difference_type>(n) * p_view->m_strides[dim - m_offset];
+        }
+    }
+
+    template <bool is_const, class CT, class S>
+    inline void xstrided_view_stepper<is_const, CT, S>::step_back(size_type dim, size_type n)
+    {
+        if (dim >= m_offset)
+        {
+            m_it -= static_cast<difference_type>(n) * p_view->m_strides[dim - m_offset];
+        }
+    }
+
+    template <bool is_const, class CT, class S>
+    inline void xstrided_view_stepper<is_const, CT, S>::reset(size_type dim)
+    {
+        if (dim >= m_offset)
+        {
+            m_it -= p_view->m_backstrides[dim - m_offset];
+        }
+    }
+
+    template <bool is_const, class CT, class S>
+    inline void xstrided_view_stepper<is_const, CT, S>::to_end()
+    {
+        m_it = p_view->data_xbegin() + p_view->end_offset();
+    }
+
+    template <bool is_const, class CT, class S>
+    inline bool xstrided_view_stepper<is_const, CT, S>::equal(const xstrided_view_stepper& rhs) const
+    {
+        return p_view == rhs.p_view && m_it == rhs.m_it && m_offset == rhs.m_offset;
+    }
+
+    template <bool is_const, class CT, class S>
+    inline bool operator==(const xstrided_view_stepper<is_const, CT, S>& lhs,
+                           const xstrided_view_stepper<is_const, CT, S>& rhs)
+    {
+        return lhs.equal(rhs);
+    }
+
+    template <bool is_const, class CT, class S>
+    inline bool operator!=(const xstrided_view_stepper<is_const, CT, S>& lhs,
+                           const xstrided_view_stepper<is_const, CT, S>& rhs)
+    {
+        return !(lhs.equal(rhs));
+    }
+
+    /*****************************************
+     * transpose and swapaxes implementation *
+     *****************************************/
+
+    namespace detail
+    {
+        template <class CT>
+        class transpose_fn
+        {
+        public:
+
+            using xexpression_type = std::decay_t<CT>;
+            using value_type = typename xexpression_type::value_type;
+            using size_type = typename xexpression_type::size_type;
+
+            template <class CTA, class S>
+            transpose_fn(CTA&& source, const S& permutation)
+                : m_source(std::forward<CTA>(source)), m_permutation(permutation.cbegin(), permutation.cend())
+            {
+            }
+
+            template <class... Args>
+            inline value_type operator()(Args... args) const
+            {
+                std::array<size_type, sizeof...(Args)> idx({static_cast<size_type>(args)...});
+                return access_impl(idx.cbegin(), idx.cend());
+            }
+
+            template <class It>
+            inline value_type element(It first, It last) const
+            {
+                return access_impl(first, last);
+            }
+
+        private:
+
+            // Missing trailing indices are zero and extra leading ones
+            // are dropped, as for the element access of containers
+            template <class It>
+            inline value_type access_impl(It first, It last) const
+            {
+                size_type dim = m_permutation.size();
+                auto nb_indices = static_cast<size_type>(std::distance(first, last));
+                if (nb_indices > dim)
+                {
+                    std::advance(first, nb_indices - dim);
+                    nb_indices = dim;
+                }
+                index_buffer idx(dim, size_type(0));
+                for (size_type i = 0; i < nb_indices; ++i, ++first)
+                {
+                    idx[m_permutation[i]] = static_cast<size_type>(*first);
+                }
+                return m_source.element(idx.cbegin(), idx.cend());
+            }
+
+            CT m_source;
+            index_buffer m_permutation;
+        };
+
+        // The size of the permutation is always checked since it bounds
+        // the permuted sequences; the axes are only checked on demand
+        template <class E, class S>
+        inline void check_permutation_size(const E& e, const S& permutation)
+        {
+            if (permutation.size() != e.dimension())
+            {
+                throw transpose_error("Permutation does not have the same size as shape");
+            }
+        }
+
+        template <class E, class S>
+        inline void check_permutation(const E& e, const S& permutation, check_policy::full)
+        {
+            check_permutation_size(e, permutation);
+            std::vector<bool> seen(permutation.size(), false);
+            for (const auto& axis : permutation)
+            {
+                auto a = static_cast<std::size_t>(axis);
+                if (a >= seen.size() || seen[a])
+                {
+                    throw transpose_error("Permutation contains wrong axis");
+                }
+                seen[a] = true;
+            }
+        }
+
+        template <class E, class S>
+        inline void check_permutation(const E& e, const S& permutation, check_policy::none)
+        {
+            check_permutation_size(e, permutation);
+        }
+
+        template <class R, class T, class S>
+        inline R permute_sequence(const T& sequence, const S& permutation)
+        {
+            using value_type = typename R::value_type;
+            R res = make_sequence<R>(sequence.size(), value_type(0));
+            auto axis = std::begin(permutation);
+            for (std::size_t i = 0; i < res.size(); ++i, ++axis)
+            {
+                res[i] = static_cast<value_type>(sequence[static_cast<std::size_t>(*axis)]);
+            }
+            return res;
+        }
+
+        // Containers with a buffer are transposed by a strided view with
+        // permuted shape and strides
+        template <class E, class S>
+        inline auto make_transpose(E&& e, const S& permutation, std::integral_constant<int, 0>)
+        {
+            using view_type = xstrided_view<closure_t<E>>;
+            using shape_type = typename view_type::shape_type;
+            using strides_type = typename view_type::strides_type;
+            shape_type shape = permute_sequence<shape_type>(e.shape(), permutation);
+            strides_type strides = permute_sequence<strides_type>(e.strides(), permutation);
+            return view_type(std::forward<E>(e), std::move(shape), std::move(strides), 0);
+        }
+
+        // Views on such containers give a strided view on the container
+        template <class E, class S>
+        inline auto make_transpose(E&& e, const S& permutation, std::integral_constant<int, 1>)
+        {
+            using view_type = xstrided_view<collapsed_closure_t<E>, typename std::decay_t<E>::shape_type>;
+            using shape_type = typename view_type::shape_type;
+            using strides_type = typename view_type::strides_type;
+            shape_type shape = permute_sequence<shape_type>(e.shape(), permutation);
+            strides_type strides = permute_sequence<strides_type>(e.strides(), permutation);
+            auto offset = e.raw_data_offset() - e.expression().raw_data_offset();
+            return view_type(collapsed_expression(e), std::move(shape), std::move(strides), offset);
+        }
+
+        // Other expressions are transposed by a generator permuting the
+        // indices
+        template <class E, class S>
+        inline auto make_transpose(E&& e, const S& permutation, std::integral_constant<int, 2>)
+        {
+            using shape_type = typename std::decay_t<E>::shape_type;
+            shape_type shape = permute_sequence<shape_type>(e.shape(), permutation);
+            return make_xgenerator(transpose_fn<xclosure_t<E>>(std::forward<E>(e), permutation), shape);
+        }
+
+        template <class E>
+        using transpose_kind = std::integral_constant<int,
+            (std::is_base_of<xcontainer<std::decay_t<E>>, std::decay_t<E>>::value && has_strided_data<std::decay_t<E>>::value) ? 0 :
+            is_collapsible_view<std::decay_t<E>>::value ? 1 : 2>;
+    }
+
+    /**
+     * @brief Reverses the axes of an expression.
+     *
+     * Containers and views on containers are transposed without copy: the
+     * result is an \ref xstrided_view on the same buffer, with reversed shape
+     * and strides. Other expressions are transposed by a generator.
+     *
+     * @param e the input expression
+     * @sa swapaxes
+     */
+    template <class E>
+    inline auto transpose(E&& e)
+    {
+        std::vector<std::size_t> permutation(e.dimension());
+        std::iota(permutation.rbegin(), permutation.rend(), std::size_t(0));
+        return detail::make_transpose(std::forward<E>(e), permutation, detail::transpose_kind<E>());
+    }
+
+    /**
+     * @brief Permutes the axes of an expression.
+     *
+     * Axis \c i of the result is axis \c permutation[i] of \c e. Containers
+     * and views on containers are transposed without copy, other expressions
+     * by a generator.
+     *
+     * @param e the input expression
+     * @param permutation the sequence containing the permutation of the axes
+     * @param check_policy check_policy::full checks that the permutation is
+     * valid and throws a transpose_error otherwise, check_policy::none only
+     * checks that it has as many axes as \c e
+     * @sa swapaxes
+     */
+    template <class E, class S, class Tag>
+    inline auto transpose(E&& e, S&& permutation, Tag check_policy)
+    {
+        detail::check_permutation(e, permutation, check_policy);
+        return detail::make_transpose(std::forward<E>(e), permutation, detail::transpose_kind<E>());
+    }
+
+    template <class E, class I, std::size_t N, class Tag>
+    inline auto transpose(E&& e, const I (&permutation)[N], Tag check_policy)
+    {
+        std::array<std::size_t, N> perm;
+        std::copy(std::begin(permutation), std::end(permutation), perm.begin());
+        return transpose(std::forward<E>(e), perm, check_policy);
+    }
+
+    /**
+     * @brief Interchanges two axes of an expression.
+     *
+     * @param e the input expression
+     * @param axis1 the first axis
+     * @param axis2 the second axis
+     * @throw transpose_error if an axis is out of range
+     * @sa transpose
+     */
+    template <class E>
+    inline auto swapaxes(E&& e, std::size_t axis1, std::size_t axis2)
+    {
+        std::vector<std::size_t> permutation(e.dimension());
+        if (axis1 >= permutation.size() || axis2 >= permutation.size())
+        {
+            throw transpose_error("Axis out of range");
+        }
+        std::iota(permutation.begin(), permutation.end(), std::size_t(0));
+        std::swap(permutation[axis1], permutation[axis2]);
+        return detail::make_transpose(std::forward<E>(e), permutation, detail::transpose_kind<E>());
+    }
+
+    /*******************************
+     * reshape_view implementation *
+     *******************************/
+
+    namespace detail
+    {
+        // Computes the strides addressing, with new_shape, the elements of
+        // an expression of shape old_shape and strides old_strides taken in
+        // row-major order. Returns false when the old strides do not allow
+        // it and a copy would be required, as NumPy does.
+        template <class S1, class ST1, class S2, class ST2>
+        inline bool reshaped_strides(const S1& old_shape, const ST1& old_strides, const S2& new_shape, ST2& new_strides)
+        {
+            using stride_type = typename ST2::value_type;
+            std::fill(new_strides.begin(), new_strides.end(), stride_type(0));
+            if (compute_size(new_shape) == 0)
+            {
+                return true;
+            }
+            // Dimensions of size one do not constrain the layout
+            std::vector<std::size_t> old_dims;
+            std::vector<stride_type> old_st;
+            for (std::size_t i = 0; i < old_shape.size(); ++i)
+            {
+                if (old_shape[i] != 1)
+                {
+                    old_dims.push_back(old_shape[i]);
+                    old_st.push_back(static_cast<stride_type>(old_strides[i]));
+                }
+            }
+            std::size_t old_i = 0, old_j = 1, new_i = 0, new_j = 1;
+            while (new_i < new_shape.size() && old_i < old_dims.size())
+            {
+                // Smallest groups of dimensions with the same size
+                std::size_t new_size = new_shape[new_i];
+                std::size_t old_size = old_dims[old_i];
+                while (new_size != old_size)
+                {
+                    if (new_size < old_size)
+                    {
+                        new_size *= new_shape[new_j++];
+                    }
+                    else
+                    {
+                        old_size *= old_dims[old_j++];
+                    }
+                }
+                for (std::size_t k = old_i; k + 1 < old_j; ++k)
+                {
+                    if (old_st[k] != static_cast<stride_type>(old_dims[k + 1]) * old_st[k + 1])
+                    {
+                        return false;
+                    }
+                }
+                new_strides[new_j - 1] = old_st[old_j - 1];
+                for (std::size_t k = new_j - 1; k > new_i; --k)
+                {
+                    new_strides[k - 1] = new_strides[k] * static_cast<stride_type>(new_shape[k]);
+                }
+                new_i = new_j++;
+                old_i = old_j++;
+            }
+            return true;
+        }
+
+        // Remaps the indices of the new shape to the elements of the source
+        // taken in row-major order. When the source has strided data that
+        // can be addressed with the new shape, the elements are read from
+        // its buffer with the reshaped strides instead.
+        template <class CT>
+        class reshape_fn
+        {
+        public:
+
+            using xexpression_type = std::decay_t<CT>;
+            using value_type = typename xexpression_type::value_type;
+            using size_type = typename xexpression_type::size_type;
+            using strides_type = std::vector<std::ptrdiff_t>;
+
+            template <class CTA, class S>
+            reshape_fn(CTA&& source, const S& shape)
+                : m_source(std::forward<CTA>(source)), m_shape(shape.cbegin(), shape.cend()),
+                  m_strides(shape.size(), 0), m_strided(false)
+            {
+                init_strides(std::integral_constant<bool, has_strided_data<xexpression_type>::value>());
+            }
+
+            template <class... Args>
+            inline value_type operator()(Args... args) const
+            {
+                std::array<size_type, sizeof...(Args)> idx({static_cast<size_type>(args)...});
+                return access_impl(idx.cbegin(), idx.cend());
+            }
+
+            template <class It>
+            inline value_type element(It first, It last) const
+            {
+                return access_impl(first, last);
+            }
+
+        private:
+
+            void init_strides(std::true_type)
+            {
+                m_strided = reshaped_strides(m_source.shape(), m_source.strides(), m_shape, m_strides);
+            }
+
+            void init_strides(std::false_type) noexcept
+            {
+            }
+
+            template <class It>
+            inline value_type access_impl(It first, It last) const
+            {
+                size_type dim = m_shape.size();
+                auto nb_indices = static_cast<size_type>(std::distance(first, last));
+                if (nb_indices > dim)
+                {
+                    std::advance(first, nb_indices - dim);
+                    nb_indices = dim;
+                }
+                return m_strided ? strided_access(first, nb_indices, std::integral_constant<bool, has_strided_data<xexpression_type>::value>())
+                                 : remapped_access(first, nb_indices);
+            }
+
+            template <class It>
+            inline value_type strided_access(It first, size_type nb_indices, std::true_type) const
+            {
+                std::ptrdiff_t offset = static_cast<std::ptrdiff_t>(m_source.raw_data_offset());
+                for (size_type i = 0; i < nb_indices; ++i)
+                {
+                    offset += static_cast<std::ptrdiff_t>(*first++) * m_strides[i];
+                }
+                return m_source.raw_data()[offset];
+            }
+
+            template <class It>
+            inline value_type strided_access(It first, size_type nb_indices, std::false_type) const
+            {
+                return remapped_access(first, nb_indices);
+            }
+
+            // Computes the row-major position of the index in the new
+            // shape, then the index of this position in the source
+            template <class It>
+            inline value_type remapped_access(It first, size_type nb_indices) const
+            {
+                size_type dim = m_shape.size();
+                size_type position = 0;
+                for (size_type i = 0; i < dim; ++i)
+                {
+                    position = position * m_shape[i] + (i < nb_indices ? static_cast<size_type>(*first++) : size_type(0));
+                }
+                const auto& source_shape = m_source.shape();
+                index_buffer idx(source_shape.size(), size_type(0));
+                for (size_type d = idx.size(); d != 0; --d)
+                {
+                    idx[d - 1] = position % source_shape[d - 1];
+                    position /= source_shape[d - 1];
+                }
+                return m_source.element(idx.cbegin(), idx.cend());
+            }
+
+            CT m_source;
+            index_buffer m_shape;
+            strides_type m_strides;
+            bool m_strided;
+        };
+
+        template <class CT, class E, class S>
+        inline auto make_reshape_strided_view(CT&& source, const E& e, S&& shape)
+        {
+            using view_type = xstrided_view<CT, std::decay_t<S>>;
+            using shape_type = typename view_type::shape_type;
+            using strides_type = typename view_type::strides_type;
+            shape_type new_shape = std::forward<S>(shape);
+            strides_type strides = make_sequence<strides_type>(new_shape.size(), 0);
+            reshaped_strides(e.shape(), e.strides(), new_shape, strides);
+            return view_type(std::forward<CT>(source), std::move(new_shape), std::move(strides), e.raw_data_offset());
+        }
+
+        // Row-major containers are reshaped by a strided view on their buffer
+        template <class E, class S>
+        inline auto make_reshape_view(E&& e, S&& shape, std::integral_constant<int, 0>)
+        {
+            return make_reshape_strided_view<closure_t<E>>(std::forward<E>(e), e, std::forward<S>(shape));
+        }
+
+        // Contiguous views are reshaped by a strided view on the buffer of
+        // their container
+        template <class E, class S>
+        inline auto make_reshape_view(E&& e, S&& shape, std::integral_constant<int, 2>)
+        {
+            return make_reshape_strided_view<collapsed_closure_t<E>>(collapsed_expression(e), e, std::forward<S>(shape));
+        }
+
+        // Other expressions, including views whose contiguity is only
+        // known at runtime, are reshaped by a generator remapping the indices
+        template <class E, class S>
+        inline auto make_reshape_view(E&& e, S&& shape, std::integral_constant<int, 1>)
+        {
+            using shape_type = std::decay_t<S>;
+            shape_type new_shape = std::forward<S>(shape);
+            reshape_fn<xclosure_t<E>> f(std::forward<E>(e), new_shape);
+            return make_xgenerator(std::move(f), new_shape);
+        }
+
+        template <class E>
+        struct is_row_major_container
+            : std::integral_constant<bool, std::is_base_of<xcontainer<E>, E>::value && has_strided_data<E>::value &&
+                                               E::layout_type == layout::row_major>
+        {
+        };
+
+        // Whether slices select a contiguous block of a row-major buffer:
+        // integral slices, then at most one unit-step range or whole
+        // dimension, then whole dimensions only. New axes have size one.
+        template <bool in_block, class... S>
+        struct contiguous_slices : std::true_type
+        {
+        };
+
+        template <bool in_block, class S, class... R>
+        struct contiguous_slices<in_block, S, R...>
+            : std::integral_constant<bool, std::is_integral<S>::value && !in_block && contiguous_slices<in_block, R...>::value>
+        {
+        };
+
+        template <bool in_block, class T, class... R>
+        struct contiguous_slices<in_block, xrange<T>, R...>
+            : std::integral_constant<bool, !in_block && contiguous_slices<true, R...>::value>
+        {
+        };
+
+        template <bool in_block, class T, class... R>
+        struct contiguous_slices<in_block, xall<T>, R...> : contiguous_slices<true, R...>
+        {
+        };
+
+        template <bool in_block, class T, class... R>
+        struct contiguous_slices<in_block, xnewaxis<T>, R...> : contiguous_slices<in_block, R...>
+        {
+        };
+
+        template <class E>
+        struct is_contiguous_view : std::false_type
+        {
+        };
+
+        template <class CT, class... S>
+        struct is_contiguous_view<xview<CT, S...>>
+            : std::integral_constant<bool, is_collapsible_view<xview<CT, S...>>::value &&
+                                               is_row_major_container<std::decay_t<CT>>::value && contiguous_slices<false, S...>::value>
+        {
+        };
+
+        template <class E>
+        using reshape_kind = std::integral_constant<int, is_row_major_container<std::decay_t<E>>::value ? 0 : (is_contiguous_view<std::decay_t<E>>::value ? 2 : 1)>;
+    }
+
+    /**
+     * @brief Returns a view of an expression with a different shape.
+     *
+     * The elements of the expression are taken in row-major order. Row-major
+     * containers and views selecting a contiguous block of them, such as
+     * ranges of rows, are reshaped without copy: the result is an
+     * \ref xstrided_view on their buffer, through which the elements can be
+     * modified. Other expressions are reshaped by a read-only generator
+     * remapping the indices; for views on containers whose dimensions can be
+     * merged, it reads the buffer through reshaped strides.
+     *
+     * @param e the input expression
+     * @param shape the new shape
+     * @throw std::runtime_error if the size of the new shape differs from the
+     * size of the expression
+     */
+    template <class E, class S>
+    inline auto reshape_view(E&& e, S&& shape)
+    {
+        if (compute_size(shape) != e.size())
+        {
+            throw std::runtime_error("reshape_view: the new shape must have the same size as the expression");
+        }
+        return detail::make_reshape_view(std::forward<E>(e), std::forward<S>(shape), detail::reshape_kind<E>());
+    }
+
+    template <class E, class I, std::size_t N>
+    inline auto reshape_view(E&& e, const I (&shape)[N])
+    {
+        std::array<std::size_t, N> new_shape;
+        std::copy(std::begin(shape), std::end(shape), new_shape.begin());
+        return reshape_view(std::forward<E>(e), std::move(new_shape));
+    }
+}
+
+#endif
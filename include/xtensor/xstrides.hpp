@@ -9,9 +9,11 @@
 #ifndef XSTRIDES_HPP
 #define XSTRIDES_HPP
 
+#include <array>
 #include <cstddef>
 #include <functional>
 #include <numeric>
+#include <vector>
 
 #include "xexception.hpp"
 #include "xtensor_forward.hpp"
@@ -35,6 +37,33 @@ namespace xt
     template <class size_type, class S, class It>
     size_type element_offset(const S& strides, It first, It last) noexcept;
 
+    /****************
+     * strides type *
+     ****************/
+
+    namespace detail
+    {
+        // Strides of a view may be negative, they are stored in a
+        // sequence of the same kind as the shape with a signed value type
+        template <class S>
+        struct signed_strides_type
+        {
+            using type = std::vector<std::ptrdiff_t>;
+        };
+
+        template <class I, std::size_t N>
+        struct signed_strides_type<std::array<I, N>>
+        {
+            using type = std::array<std::ptrdiff_t, N>;
+        };
+    }
+
+    template <class S>
+    using signed_strides_type_t = typename detail::signed_strides_type<S>::type;
+
+    template <class S, class ST>
+    bool has_row_major_strides(const S& shape, const ST& strides) noexcept;
+
     /*******************
      * strides builder *
      *******************/
@@ -97,6 +126,28 @@ namespace xt
         return std::inner_product(efirst, last, strides.begin(), size_type(0));
     }
 
+    // Whether the strides walk a contiguous buffer in row-major order,
+    // dimensions of size one having a null stride
+    template <class S, class ST>
+    inline bool has_row_major_strides(const S& shape, const ST& strides) noexcept
+    {
+        if (shape.size() != strides.size())
+        {
+            return false;
+        }
+        std::ptrdiff_t data_size = 1;
+        for (std::size_t i = shape.size(); i != 0; --i)
+        {
+            std::ptrdiff_t expected = shape[i - 1] == 1 ? 0 : data_size;
+            if (static_cast<std::ptrdiff_t>(strides[i - 1]) != expected)
+            {
+                return false;
+            }
+            data_size *= static_cast<std::ptrdiff_t>(shape[i - 1]);
+        }
+        return true;
+    }
+
     namespace detail
     {
         template <class shape_type, class strides_type, class bs_ptr>
@@ -44,6 +44,11 @@ namespace xt
     {
     };
 
+    template <class EC, std::size_t N, layout L>
+    struct is_concurrently_readable<xtensor_container<EC, N, L>> : std::true_type
+    {
+    };
+
     /**
      * @class xtensor_container
      * @brief Dense multidimensional container with tensor semantic and fixed
@@ -134,6 +139,11 @@ namespace xt
     {
     };
 
+    template <class EC, std::size_t N, layout L>
+    struct is_concurrently_readable<xtensor_adaptor<EC, N, L>> : std::true_type
+    {
+    };
+
     /**
      * @class xtensor_adaptor
      * @brief Dense multidimensional container adaptor with tensor semantic
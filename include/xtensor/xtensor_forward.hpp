@@ -17,6 +17,16 @@
 
 namespace xt
 {
+    namespace check_policy
+    {
+        struct none
+        {
+        };
+        struct full
+        {
+        };
+    }
+
     template <class C>
     struct xcontainer_inner_types;
 
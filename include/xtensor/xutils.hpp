@@ -738,6 +738,21 @@ namespace xt
         static constexpr bool value = detail::is_complex<std::decay_t<T>>::value;
     };
 
+    /*****************************
+     * dtype_kind implementation *
+     *****************************/
+
+    // NumPy-like character code of a scalar type ('b', 'i', 'u', 'f' or 'c'),
+    // used to tag the values written by the binary storage formats.
+    template <class T>
+    constexpr char dtype_kind() noexcept
+    {
+        return std::is_same<T, bool>::value ? 'b' :
+            is_complex<T>::value ? 'c' :
+            std::is_floating_point<T>::value ? 'f' :
+            std::is_signed<T>::value ? 'i' : 'u';
+    }
+
     /*********************************
      * forward_offset implementation *
      *********************************/
@@ -20,6 +20,8 @@
 #include "xcontainer.hpp"
 #include "xiterable.hpp"
 #include "xsemantic.hpp"
+#include "xstrided_view.hpp"
+#include "xstrides.hpp"
 #include "xtensor_forward.hpp"
 #include "xview_utils.hpp"
 
@@ -56,6 +58,12 @@ namespace xt
         using const_iterator = const_broadcast_iterator;
     };
 
+    template <class CT, class... S>
+    struct is_concurrently_readable<xview<CT, S...>>
+        : is_concurrently_readable<std::decay_t<CT>>
+    {
+    };
+
     /**
      * @class xview
      * @brief Multidimensional view with tensor semantic.
@@ -92,6 +100,7 @@ namespace xt
         using iterable_base = xexpression_iterable<self_type>;
         using inner_shape_type = typename iterable_base::inner_shape_type;
         using shape_type = inner_shape_type;
+        using strides_type = signed_strides_type_t<shape_type>;
 
         using slice_type = std::tuple<S...>;
 
@@ -123,6 +132,9 @@ namespace xt
         const slice_type& slices() const noexcept;
         xt::layout layout() const noexcept;
 
+        xexpression_type& expression() noexcept;
+        const xexpression_type& expression() const noexcept;
+
         template <class... Args>
         reference operator()(Args... args);
         reference operator[](const xindex& index);
@@ -158,19 +170,19 @@ namespace xt
         data() const;
 
         template <class T = xexpression_type>
-        std::enable_if_t<std::is_base_of<xcontainer<std::remove_const_t<T>>, T>::value, const typename T::strides_type>
+        std::enable_if_t<has_strided_data<T>::value, strides_type>
         strides() const;
 
         template <class T = xexpression_type>
-        std::enable_if_t<std::is_base_of<xcontainer<std::remove_const_t<T>>, T>::value, const value_type*>
+        std::enable_if_t<has_strided_data<T>::value, const value_type*>
         raw_data() const;
 
         template <class T = xexpression_type>
-        std::enable_if_t<std::is_base_of<xcontainer<std::remove_const_t<T>>, T>::value, value_type*>
+        std::enable_if_t<has_strided_data<T>::value, value_type*>
         raw_data();
 
         template <class T = xexpression_type>
-        std::enable_if_t<std::is_base_of<xcontainer<std::remove_const_t<T>>, T>::value, const typename T::size_type>
+        std::enable_if_t<has_strided_data<T>::value, const typename T::size_type>
         raw_data_offset() const;
 
     private:
@@ -208,11 +220,19 @@ namespace xt
         disable_xslice<T, size_type> sliced_access(const T& squeeze, Args...) const;
 
         using temporary_type = typename xcontainer_inner_types<self_type>::temporary_type;
-        using base_index_type = xindex_type_t<shape_type>;
+        using base_index_type = xindex_type_t<typename xexpression_type::shape_type>;
 
         template <class It>
         base_index_type make_index(It first, It last) const;
 
+        template <class ST>
+        bool is_trivial_broadcast_impl(const ST& strides, std::true_type) const;
+
+        template <class ST>
+        bool is_trivial_broadcast_impl(const ST& strides, std::false_type) const;
+
+        bool is_newaxis_slice(size_type index) const noexcept;
+
         void assign_temporary_impl(temporary_type& tmp);
 
         friend class xview_semantic<xview<CT, S...>>;
@@ -282,8 +302,7 @@ namespace xt
 
         bool is_newaxis_slice(size_type index) const noexcept;
 
-        template <class F>
-        void common_step(size_type dim, size_type n, F f);
+        void common_step(size_type dim, size_type n, bool forward);
 
         view_type* p_view;
         substepper_type m_it;
@@ -426,6 +445,24 @@ namespace xt
         return layout_type;
     }
 
+    /**
+     * Returns a reference to the underlying expression of the view.
+     */
+    template <class CT, class... S>
+    inline auto xview<CT, S...>::expression() noexcept -> xexpression_type&
+    {
+        return m_e;
+    }
+
+    /**
+     * Returns a constant reference to the underlying expression of the view.
+     */
+    template <class CT, class... S>
+    inline auto xview<CT, S...>::expression() const noexcept -> const xexpression_type&
+    {
+        return m_e;
+    }
+
     /**
      * Returns the data holder of the underlying container (only if the view is on a realized
      * container). ``xt::eval`` will make sure that the underlying xexpression is 
@@ -440,22 +477,28 @@ namespace xt
     }
 
     /**
-     * Return the strides for the underlying container of the view.
+     * Returns the strides of the view in the buffer of the underlying
+     * container. A stepped slice multiplies the stride of the dimension
+     * it slices by its step, which may be negative; new axes and
+     * dimensions of size one have a null stride.
      */
     template <class E, class... S>
     template <class T>
     inline auto xview<E, S...>::strides() const ->
-        std::enable_if_t<std::is_base_of<xcontainer<std::remove_const_t<T>>, T>::value, const typename T::strides_type>
+        std::enable_if_t<has_strided_data<T>::value, strides_type>
     {
-        using strides_type = typename T::strides_type;
-        strides_type temp = m_e.strides();
-        strides_type strides = make_sequence<strides_type>(sizeof...(S) - integral_count<S...>(), 0);
-
-        auto func = [](const auto& s) { return xt::step_size(s); };
-
-        for (size_type i = 0; i < strides.size(); ++i) {
-            auto idx = integral_skip<S...>(i);
-            strides[i] = m_e.strides()[idx] * apply<size_type>(idx, func, m_slices);
+        strides_type strides = make_sequence<strides_type>(dimension(), 0);
+        const auto& e_strides = m_e.strides();
+        auto func = [](const auto& s) { return static_cast<std::ptrdiff_t>(xt::step_size(s)); };
+        for (size_type i = 0; i != dimension(); ++i)
+        {
+            size_type index = integral_skip<S...>(i);
+            if (m_shape[i] == 1 || (index < sizeof...(S) && is_newaxis_slice(index)))
+            {
+                continue;
+            }
+            auto stride = static_cast<std::ptrdiff_t>(e_strides[index - newaxis_count_before<S...>(index)]);
+            strides[i] = index < sizeof...(S) ? stride * apply<std::ptrdiff_t>(index, func, m_slices) : stride;
         }
         return strides;
     }
@@ -466,7 +509,7 @@ namespace xt
     template <class E, class... S>
     template <class T>
     inline auto xview<E, S...>::raw_data() const ->
-        std::enable_if_t<std::is_base_of<xcontainer<std::remove_const_t<T>>, T>::value, const value_type*>
+        std::enable_if_t<has_strided_data<T>::value, const value_type*>
     {
         return m_e.raw_data();
     }
@@ -474,7 +517,7 @@ namespace xt
     template <class E, class... S>
     template <class T>
     inline auto xview<E, S...>::raw_data() ->
-        std::enable_if_t<std::is_base_of<xcontainer<std::remove_const_t<T>>, T>::value, value_type*>
+        std::enable_if_t<has_strided_data<T>::value, value_type*>
     {
         return m_e.raw_data();
     }
@@ -485,17 +528,19 @@ namespace xt
     template <class E, class... S>
     template <class T>
     inline auto xview<E, S...>::raw_data_offset() const ->
-        std::enable_if_t<std::is_base_of<xcontainer<std::remove_const_t<T>>, T>::value, const typename T::size_type>
+        std::enable_if_t<has_strided_data<T>::value, const typename T::size_type>
     {
-        auto func = [](const auto& s) { return xt::value(s, 0); };
-        typename T::size_type offset = 0;
-
+        auto func = [](const auto& s) { return static_cast<std::ptrdiff_t>(xt::value(s, 0)); };
+        const auto& e_strides = m_e.strides();
+        auto offset = static_cast<std::ptrdiff_t>(m_e.raw_data_offset());
         for (size_type i = 0; i < sizeof...(S); ++i)
         {
-            size_type s = apply<size_type>(i, func, m_slices) * m_e.strides()[i];
-            offset += s;
+            if (!is_newaxis_slice(i))
+            {
+                offset += apply<std::ptrdiff_t>(i, func, m_slices) * static_cast<std::ptrdiff_t>(e_strides[i - newaxis_count_before<S...>(i)]);
+            }
         }
-        return offset;
+        return static_cast<typename T::size_type>(offset);
     }
     //@}
 
@@ -594,14 +639,16 @@ namespace xt
 
     /**
      * Compares the specified strides with those of the view to see whether
-     * the broadcasting is trivial.
+     * the broadcasting is trivial. This is only the case for a view on a
+     * container whose strides match the specified ones and walk its
+     * elements contiguously in row-major order.
      * @return a boolean indicating whether the broadcasting is trivial
      */
     template <class CT, class... S>
     template <class ST>
-    inline bool xview<CT, S...>::is_trivial_broadcast(const ST& /*strides*/) const
+    inline bool xview<CT, S...>::is_trivial_broadcast(const ST& strides) const
     {
-        return false;
+        return is_trivial_broadcast_impl(strides, std::integral_constant<bool, has_strided_data<xexpression_type>::value>());
     }
     //@}
 
@@ -686,10 +733,37 @@ namespace xt
         return index;
     }
 
+    template <class CT, class... S>
+    template <class ST>
+    inline bool xview<CT, S...>::is_trivial_broadcast_impl(const ST& strides, std::true_type) const
+    {
+        strides_type view_strides = this->strides();
+        auto equal_stride = [](const auto& lhs, const auto& rhs) { return static_cast<std::ptrdiff_t>(lhs) == rhs; };
+        return strides.size() == view_strides.size() &&
+            std::equal(strides.cbegin(), strides.cend(), view_strides.cbegin(), equal_stride) &&
+            has_row_major_strides(m_shape, view_strides);
+    }
+
+    template <class CT, class... S>
+    template <class ST>
+    inline bool xview<CT, S...>::is_trivial_broadcast_impl(const ST& /*strides*/, std::false_type) const
+    {
+        return false;
+    }
+
+    template <class CT, class... S>
+    inline bool xview<CT, S...>::is_newaxis_slice(size_type index) const noexcept
+    {
+        return newaxis_count_before<S...>(index + 1) != newaxis_count_before<S...>(index);
+    }
+
     template <class CT, class... S>
     inline void xview<CT, S...>::assign_temporary_impl(temporary_type& tmp)
     {
-        std::copy(tmp.cbegin(), tmp.cend(), this->xbegin());
+        if (!detail::strided_assign(*this, tmp))
+        {
+            std::copy(tmp.cbegin(), tmp.cend(), this->xbegin());
+        }
     }
 
     namespace detail
@@ -701,19 +775,31 @@ namespace xt
         }
 
         template <class E, std::size_t... I, class... S>
-        inline auto make_view_impl(E&& e, std::index_sequence<I...>, S&&... slices)
+        inline auto make_view_impl(E&& e, std::false_type, std::index_sequence<I...>, S&&... slices)
         {
             using view_type = xview<closure_t<E>, get_slice_type<std::decay_t<E>, S>...>;
             return view_type(std::forward<E>(e),
                 get_slice_implementation(e, std::forward<S>(slices), get_underlying_shape_index<std::decay_t<E>, S...>(I))...
             );
         }
+
+        template <class E, std::size_t... I, class... S>
+        inline auto make_view_impl(E&& e, std::true_type, std::index_sequence<I...> seq, S&&... slices)
+        {
+            const std::decay_t<E>& inner = e;
+            auto composed = make_view_impl(inner, std::false_type(), seq, std::forward<S>(slices)...);
+            using view_type = xstrided_view<collapsed_closure_t<E>, typename decltype(composed)::shape_type>;
+            auto offset = composed.raw_data_offset() - inner.expression().raw_data_offset();
+            return view_type(collapsed_expression(e), composed.shape(), composed.strides(), offset);
+        }
     }
 
     /**
      * Constructs and returns a view on the specified xexpression. Users
      * should not directly construct the slices but call helper functions
-     * instead.
+     * instead. When \c e is itself a view referring to a container, the
+     * slices are composed with those of \c e and the result is a single
+     * \ref xstrided_view on the container instead of a nested view.
      * @param e the xexpression to adapt
      * @param slices the slices list describing the view
      * @sa range, all, newaxis
@@ -721,7 +807,8 @@ namespace xt
     template <class E, class... S>
     inline auto view(E&& e, S&&... slices)
     {
-        return detail::make_view_impl(std::forward<E>(e), std::make_index_sequence<sizeof...(S)>(), std::forward<S>(slices)...);
+        return detail::make_view_impl(std::forward<E>(e), detail::is_collapsible_view<std::decay_t<E>>(),
+                                      std::make_index_sequence<sizeof...(S)>(), std::forward<S>(slices)...);
     }
 
     /***************
@@ -795,15 +882,13 @@ namespace xt
     template <bool is_const, class CT, class... S>
     inline void xview_stepper<is_const, CT, S...>::step(size_type dim, size_type n)
     {
-        auto func = [this](size_type index, size_type offset) { m_it.step(index, offset); };
-        common_step(dim, n, func);
+        common_step(dim, n, true);
     }
 
     template <bool is_const, class CT, class... S>
     inline void xview_stepper<is_const, CT, S...>::step_back(size_type dim, size_type n)
     {
-        auto func = [this](size_type index, size_type offset) { m_it.step_back(index, offset); };
-        common_step(dim, n, func);
+        common_step(dim, n, false);
     }
 
     template <bool is_const, class CT, class... S>
@@ -821,9 +906,17 @@ namespace xt
                 {
                     size = size - 1;
                 }
-                size_type step_size = index < sizeof...(S) ? apply<size_type>(index, step_func, p_view->slices()) : 1;
+                std::ptrdiff_t step_size = index < sizeof...(S) ? apply<std::ptrdiff_t>(index, step_func, p_view->slices()) : 1;
                 index -= newaxis_count_before<S...>(index);
-                m_it.step_back(index, step_size * size);
+                // Reversed slices are walked backward in the underlying expression
+                if (step_size < 0)
+                {
+                    m_it.step(index, size_type(-step_size) * size);
+                }
+                else
+                {
+                    m_it.step_back(index, size_type(step_size) * size);
+                }
             }
         }
     }
@@ -848,8 +941,7 @@ namespace xt
     }
 
     template <bool is_const, class CT, class... S>
-    template <class F>
-    void xview_stepper<is_const, CT, S...>::common_step(size_type dim, size_type n, F f)
+    inline void xview_stepper<is_const, CT, S...>::common_step(size_type dim, size_type n, bool forward)
     {
         if (dim >= m_offset)
         {
@@ -857,10 +949,22 @@ namespace xt
             size_type index = integral_skip<S...>(dim);
             if (!is_newaxis_slice(index))
             {
-                size_type step_size = index < sizeof...(S) ?
-                    apply<size_type>(index, func, p_view->slices()) : 1;
+                std::ptrdiff_t step_size = index < sizeof...(S) ?
+                    apply<std::ptrdiff_t>(index, func, p_view->slices()) : 1;
                 index -= newaxis_count_before<S...>(index);
-                f(index, step_size * n);
+                if (step_size < 0)
+                {
+                    forward = !forward;
+                    step_size = -step_size;
+                }
+                if (forward)
+                {
+                    m_it.step(index, size_type(step_size) * n);
+                }
+                else
+                {
+                    m_it.step_back(index, size_type(step_size) * n);
+                }
             }
         }
     }
@@ -0,0 +1,82 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef TEST_FILES_HPP
+#define TEST_FILES_HPP
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace xt
+{
+    // Returns the path of the entry name in the temporary directory of the system
+    inline std::string temporary_path(const std::string& name)
+    {
+        for (const char* var : {"TMPDIR", "TMP", "TEMP"})
+        {
+            const char* dir = std::getenv(var);
+            if (dir != nullptr && *dir != '\0')
+            {
+                return std::string(dir) + "/" + name;
+            }
+        }
+#ifdef _WIN32
+        return name;
+#else
+        return "/tmp/" + name;
+#endif
+    }
+
+    inline void remove_directory(const std::string& path)
+    {
+#ifdef _WIN32
+        _rmdir(path.c_str());
+#else
+        rmdir(path.c_str());
+#endif
+    }
+
+    // Temporary file of a test, removed when the test ends
+    class temporary_file
+    {
+
+    public:
+
+        explicit temporary_file(const std::string& name)
+            : m_path(temporary_path(name))
+        {
+            std::remove(m_path.c_str());
+        }
+
+        ~temporary_file()
+        {
+            std::remove(m_path.c_str());
+        }
+
+        temporary_file(const temporary_file&) = delete;
+        temporary_file& operator=(const temporary_file&) = delete;
+
+        const std::string& path() const noexcept
+        {
+            return m_path;
+        }
+
+    private:
+
+        std::string m_path;
+    };
+}
+
+#endif
@@ -9,9 +9,12 @@
 #include "gtest/gtest.h"
 #include "xtensor/xbuilder.hpp"
 #include "xtensor/xarray.hpp"
+#include "xtensor/xtensor.hpp"
 
 #include "xtensor/xio.hpp"
+#include <cmath>
 #include <iostream>
+#include <limits>
 
 namespace xt
 {
@@ -149,6 +152,15 @@ namespace xt
         ASSERT_EQ(m_assigned[{0}], 100);
         ASSERT_EQ(m_assigned(1), at_1);
         ASSERT_EQ(m_assigned(3), 1000);
+
+        // Same values and value type as pow applied to a linspace
+        auto ils = logspace<int>(0, 6, 4, 3);
+        static_assert(std::is_same<int, decltype(ils)::value_type>::value, "logspace<int> holds int");
+        xarray<int> iassigned = ils;
+        EXPECT_EQ(xarray<int>({1, 9, 81, 729}), iassigned);
+        EXPECT_EQ(81, ils(2));
+        xarray<double> dassigned = logspace<int>(-1, 1, 3);
+        EXPECT_EQ(xarray<double>({0., 1., 10.}), dassigned);
     }
 
     TEST(xbuilder, eye)
@@ -170,6 +182,99 @@ namespace xt
         ASSERT_EQ(true, e.element(idx2.begin(), idx2.end()));
     }
 
+    TEST(xbuilder, closed_form_assign)
+    {
+        static_assert(is_cheap_expression<decltype(arange<double>(10))>::value, "arange is cheap");
+        static_assert(is_cheap_expression<decltype(eye<double>(3))>::value, "eye is cheap");
+        static_assert(!is_cheap_expression<decltype(diag(arange<double>(3)))>::value, "diag is not cheap");
+
+        auto r = linspace<double>(-1., 3., 17);
+        xarray<double> lr = r;
+        for (size_t i = 0; i < 17; ++i)
+        {
+            EXPECT_EQ(r(i), lr(i));
+        }
+        auto l = logspace<double>(0., 3., 7, 2.);
+        xarray<double> ll = l;
+        EXPECT_EQ(l(5), ll(5));
+        EXPECT_EQ(std::pow(2., 2.5), ll(5));
+
+        // Cheap expressions are assigned in place
+        xtensor<double, 1> t = arange<double>(10);
+        const double* storage = t.raw_data();
+        t = arange<double>(5., 15.);
+        EXPECT_EQ(storage, t.raw_data());
+        EXPECT_EQ(14., t(9));
+
+        for (int k : {-2, 0, 1, 4})
+        {
+            std::vector<std::size_t> shape = {2, 3, 4};
+            auto e = eye<int>(shape, k);
+            xarray<int> m = e;
+            for (size_t b = 0; b < 2; ++b)
+                for (size_t i = 0; i < 3; ++i)
+                    for (size_t j = 0; j < 4; ++j)
+                        EXPECT_EQ(e(b, i, j), m(b, i, j));
+        }
+    }
+
+    TEST(xbuilder, structural_zeros)
+    {
+        xarray<double> a = arange<double>(1., 31.);
+        a.reshape({5, 6});
+        for (int k : {-7, -2, 0, 1, 6})
+        {
+            auto l = tril(a, k);
+            auto u = triu(a, k);
+            xarray<double> la = l;
+            xarray<double> ua = u;
+            for (size_t i = 0; i < 5; ++i)
+            {
+                for (size_t j = 0; j < 6; ++j)
+                {
+                    EXPECT_EQ(l(i, j), la(i, j));
+                    EXPECT_EQ(u(i, j), ua(i, j));
+                }
+            }
+        }
+
+        xarray<double> v = {1., 2., 3.};
+        for (int k : {-1, 0, 2})
+        {
+            auto d = diag(v, k);
+            xarray<double> da = d;
+            ASSERT_EQ(d.shape()[0], da.shape()[0]);
+            for (size_t i = 0; i < da.shape()[0]; ++i)
+            {
+                for (size_t j = 0; j < da.shape()[1]; ++j)
+                {
+                    EXPECT_EQ(d(i, j), da(i, j));
+                }
+            }
+        }
+
+        // Products skip the structurally zero region of their operands
+        xarray<double> b = ones<double>({5, 6});
+        b(0, 5) = std::numeric_limits<double>::quiet_NaN();
+        auto p = tril(a) * b;
+        static_assert(has_nonzero_columns<decltype(p)>::value, "products are structured");
+        xarray<double> pa = p;
+        EXPECT_EQ(0., pa(0, 5));
+        EXPECT_EQ(a(4, 2), pa(4, 2));
+        EXPECT_EQ(0., pa(1, 2));
+        // Other evaluations still multiply the skipped NaN
+        EXPECT_TRUE(std::isnan(p(0, 5)));
+        xarray<double, layout::column_major> pc = p;
+        EXPECT_TRUE(std::isnan(pc(0, 5)));
+        EXPECT_EQ(a(4, 2), pc(4, 2));
+
+        xarray<double> band = triu(a, -1) * tril(a, 1);
+        EXPECT_EQ(a(2, 1) * a(2, 1), band(2, 1));
+        EXPECT_EQ(a(2, 3) * a(2, 3), band(2, 3));
+        EXPECT_EQ(0., band(2, 4));
+        EXPECT_EQ(0., band(3, 1));
+    }
+
     TEST(xbuilder, concatenate)
     {
         xarray<double> a = arange<double>(12);
@@ -234,6 +339,48 @@ namespace xt
         ASSERT_TRUE(t == ar);
     }
 
+    TEST(xbuilder, concatenate_stack_assign)
+    {
+        xarray<double> a = arange<double>(24);
+        a.reshape({2, 3, 4});
+        xarray<double> b = arange<double>(100., 124.);
+        b.reshape({2, 3, 4});
+        xarray<double> c = arange<double>(200., 216.);
+        c.reshape({2, 2, 4});
+
+        // Containers are copied in bulk, the generator gives the reference
+        auto gen = concatenate(xtuple(a, c), 1);
+        xarray<double> res = gen;
+        ASSERT_EQ(gen.shape(), res.shape());
+        for (size_t i = 0; i < 2; ++i)
+            for (size_t j = 0; j < 5; ++j)
+                for (size_t k = 0; k < 4; ++k)
+                    EXPECT_EQ(gen(i, j, k), res(i, j, k));
+
+        for (size_t axis = 0; axis < 4; ++axis)
+        {
+            auto sgen = stack(xtuple(a, b, a), axis);
+            xarray<double> sres = sgen;
+            xarray<double> expected = zeros<double>(sgen.shape());
+            std::copy(sgen.cbegin(), sgen.cend(), expected.begin());
+            EXPECT_EQ(expected, sres);
+        }
+
+        xarray<double> last = concatenate(xtuple(a, b), 2);
+        EXPECT_EQ(a(1, 2, 3), last(1, 2, 3));
+        EXPECT_EQ(b(1, 2, 0), last(1, 2, 4));
+
+        // Expressions fall back to the element-wise evaluation
+        xarray<double> mixed = concatenate(xtuple(a, b + 1.));
+        EXPECT_EQ(b(1, 2, 3) + 1., mixed(3, 2, 3));
+        xarray<int> ia = arange<int>(24);
+        ia.reshape({2, 3, 4});
+        xarray<int> ib = arange<int>(100, 124);
+        ib.reshape({2, 3, 4});
+        xarray<int> integral = concatenate(xtuple(ia, ib));
+        EXPECT_EQ(123, integral(3, 2, 3));
+    }
+
     TEST(xbuilder, meshgrid)
     {
         auto mesh = meshgrid(linspace<double>(0.0, 1.0, 3), linspace<double>(0.0, 1.0, 2));
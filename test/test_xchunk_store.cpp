@@ -0,0 +1,208 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xchunk_store.hpp"
+#include "xtensor/xmath.hpp"
+
+#include "test_files.hpp"
+
+namespace xt
+{
+    namespace
+    {
+        // Directory of a store of the given shapes in the temporary directory,
+        // removed with its chunk files when the test ends
+        class temporary_store
+        {
+
+        public:
+
+            using shape_type = std::vector<std::size_t>;
+
+            temporary_store(const std::string& name, const shape_type& shape, const shape_type& chunk_shape)
+                : m_path(temporary_path(name)), m_shape(shape), m_chunk_shape(chunk_shape)
+            {
+                remove();
+            }
+
+            ~temporary_store()
+            {
+                remove();
+            }
+
+            temporary_store(const temporary_store&) = delete;
+            temporary_store& operator=(const temporary_store&) = delete;
+
+            const std::string& path() const noexcept
+            {
+                return m_path;
+            }
+
+            const shape_type& shape() const noexcept
+            {
+                return m_shape;
+            }
+
+            const shape_type& chunk_shape() const noexcept
+            {
+                return m_chunk_shape;
+            }
+
+            std::string chunk_path(const std::string& name) const
+            {
+                return m_path + "/" + name;
+            }
+
+        private:
+
+            void remove() const
+            {
+                remove_chunks(0, m_path + "/");
+                std::remove(chunk_path(detail::chunk_store_metadata).c_str());
+                remove_directory(m_path);
+            }
+
+            void remove_chunks(std::size_t d, const std::string& prefix) const
+            {
+                if (d == m_shape.size())
+                {
+                    std::remove(prefix.c_str());
+                    return;
+                }
+                std::size_t nb_chunks = (m_shape[d] + m_chunk_shape[d] - 1) / m_chunk_shape[d];
+                for (std::size_t i = 0; i < nb_chunks; ++i)
+                {
+                    remove_chunks(d + 1, prefix + (d == 0 ? "" : ".") + std::to_string(i));
+                }
+            }
+
+            std::string m_path;
+            shape_type m_shape;
+            shape_type m_chunk_shape;
+        };
+    }
+
+    TEST(xchunk_store, codecs)
+    {
+        std::vector<int> values(1000);
+        for (std::size_t i = 0; i < values.size(); ++i)
+        {
+            values[i] = static_cast<int>(i / 10);
+        }
+        std::size_t nbytes = values.size() * sizeof(int);
+        const char* src = reinterpret_cast<const char*>(values.data());
+
+        std::vector<char> shuffled(nbytes);
+        detail::byte_shuffle(src, shuffled.data(), values.size(), sizeof(int));
+        detail::delta_encode(shuffled.data(), nbytes);
+        std::string compressed = detail::lz_compress(shuffled.data(), nbytes);
+        EXPECT_LT(compressed.size(), nbytes / 4);
+
+        std::vector<char> decompressed(nbytes);
+        detail::lz_decompress(compressed.data(), compressed.size(), decompressed.data(), nbytes);
+        detail::delta_decode(decompressed.data(), nbytes);
+        std::vector<int> res(values.size());
+        detail::byte_unshuffle(decompressed.data(), reinterpret_cast<char*>(res.data()), values.size(), sizeof(int));
+        EXPECT_EQ(values, res);
+
+        std::string corrupted = compressed.substr(0, compressed.size() / 2);
+        EXPECT_ANY_THROW(detail::lz_decompress(corrupted.data(), corrupted.size(), decompressed.data(), nbytes));
+    }
+
+    TEST(xchunk_store, assign_and_access)
+    {
+        temporary_store dir("xchunk_store_assign", {7, 5, 6}, {3, 2, 4});
+        xchunk_store_options options;
+        options.delta = true;
+        options.cache_size = 2;
+        auto store = create_chunked_store<double>(dir.path(), dir.shape(), dir.chunk_shape(), options);
+        EXPECT_EQ(3u, store.dimension());
+        EXPECT_EQ(210u, store.size());
+
+        xarray<double> a = arange<double>(210);
+        a.reshape({7, 5, 6});
+        store = a + 1.;
+        EXPECT_EQ(a(6, 4, 5) + 1., store(6, 4, 5));
+        EXPECT_EQ(a(2, 3, 1) + 1., store(2, 3, 1));
+
+        xarray<double> res = store;
+        EXPECT_EQ(a + 1., res);
+
+        xarray<double> row = {1., 2., 3., 4., 5., 6.};
+        store = row;
+        EXPECT_EQ(row(3), store(4, 2, 3));
+
+        xarray<double> wrong = {1., 2.};
+        EXPECT_THROW(store = wrong, broadcast_error);
+    }
+
+    TEST(xchunk_store, reopen)
+    {
+        temporary_store dir("xchunk_store_reopen", {10, 10}, {4, 4});
+        {
+            auto store = create_chunked_store<int>(dir.path(), dir.shape(), dir.chunk_shape());
+            store = 100 * arange<int>(10) + 3;
+        }
+        auto store = open_chunked_store<int>(dir.path());
+        std::vector<std::size_t> chunks = {4, 4};
+        EXPECT_EQ(chunks, store.chunk_shape());
+        EXPECT_EQ(903, store(4, 9));
+        xarray<int> res = store * 2;
+        EXPECT_EQ(2 * (100 * arange<int>(10) + 3) + zeros<int>({10, 10}), res);
+
+        EXPECT_ANY_THROW(open_chunked_store<double>(dir.path()));
+        EXPECT_THROW(create_chunked_store<int>(dir.path(), dir.shape(), dir.chunk_shape()), std::runtime_error);
+    }
+
+    TEST(xchunk_store, null_chunk_extent)
+    {
+        temporary_store dir("xchunk_store_null_extent", {10, 10}, {4, 4});
+        {
+            auto store = create_chunked_store<int>(dir.path(), dir.shape(), dir.chunk_shape());
+        }
+        std::string metadata_path = dir.chunk_path(detail::chunk_store_metadata);
+        std::string metadata;
+        {
+            std::ifstream in(metadata_path);
+            metadata.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        std::size_t pos = metadata.find("chunks 2 4 4");
+        ASSERT_NE(std::string::npos, pos);
+        metadata.replace(pos, 12, "chunks 2 0 4");
+        std::ofstream(metadata_path) << metadata;
+        EXPECT_THROW(open_chunked_store<int>(dir.path()), std::runtime_error);
+    }
+
+    TEST(xchunk_store, missing_chunks)
+    {
+        temporary_store dir("xchunk_store_missing", {4, 4}, {2, 2});
+        {
+            auto store = create_chunked_store<float>(dir.path(), dir.shape(), dir.chunk_shape());
+            EXPECT_EQ(0.f, store(3, 3));
+            EXPECT_EQ(0.f, sum(store)());
+            store = ones<float>({4, 4});
+        }
+        std::remove(dir.chunk_path("0.0").c_str());
+        std::remove(dir.chunk_path("1.1").c_str());
+        auto store = open_chunked_store<float>(dir.path());
+        EXPECT_EQ(0.f, store(1, 1));
+        EXPECT_EQ(0.f, store(3, 3));
+        EXPECT_EQ(1.f, store(0, 3));
+        EXPECT_EQ(8.f, sum(store)());
+    }
+}
@@ -0,0 +1,346 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xexecution.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xrandom.hpp"
+#include "xtensor/xreducer.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xvectorize.hpp"
+
+namespace xt
+{
+    namespace
+    {
+        // Runs a test with the parallel policy and restores the options
+        struct parallel_scope
+        {
+            parallel_scope(std::size_t nb_threads, std::size_t grain_size)
+                : m_saved(execution_options::execution_options())
+            {
+                execution_options::set_policy(execution_policy::parallel);
+                execution_options::set_nb_threads(nb_threads);
+                execution_options::set_grain_size(grain_size);
+            }
+
+            ~parallel_scope()
+            {
+                execution_options::set_policy(m_saved.policy);
+                execution_options::set_nb_threads(m_saved.nb_threads);
+                execution_options::set_grain_size(m_saved.grain_size);
+                execution_options::set_deterministic_reduction(m_saved.deterministic_reduction);
+                execution_options::set_reduction_block_size(m_saved.reduction_block_size);
+            }
+
+            execution_options::execution_options_impl m_saved;
+        };
+
+        // Numbers the elements in the order they are evaluated
+        struct counting_fun
+        {
+            double operator()(double x) const
+            {
+                return x + double((*p_count)++);
+            }
+
+            std::size_t* p_count;
+        };
+
+        struct reentrant_fun
+        {
+            static constexpr bool is_concurrently_callable = true;
+
+            double operator()(double x) const
+            {
+                return x * m_factor;
+            }
+
+            double m_factor;
+        };
+    }
+
+    TEST(xexecution, thread_pool)
+    {
+        xthread_pool pool(3);
+        EXPECT_EQ(3u, pool.size());
+        std::vector<int> visited(1000, 0);
+        std::atomic<std::size_t> nb_calls(0);
+        pool.parallel_for(0, visited.size(), 10, [&](std::size_t b, std::size_t e) {
+            if (e != visited.size())
+            {
+                EXPECT_LE(10u, e - b);
+            }
+            for (std::size_t i = b; i < e; ++i)
+            {
+                ++visited[i];
+            }
+            ++nb_calls;
+        });
+        EXPECT_EQ(std::vector<int>(1000, 1), visited);
+        EXPECT_LT(1u, nb_calls.load());
+
+        pool.resize(1);
+        EXPECT_EQ(1u, pool.size());
+        EXPECT_THROW(pool.parallel_for(0, 100, 1, [](std::size_t b, std::size_t) {
+                         if (b >= 50)
+                         {
+                             throw std::runtime_error("block failed");
+                         }
+                     }),
+                     std::runtime_error);
+    }
+
+    TEST(xexecution, nested)
+    {
+        parallel_scope scope(4, 1);
+        std::vector<int> visited(64, 0);
+        parallel_for(0, 8, 1, [&visited](std::size_t b, std::size_t e) {
+            for (std::size_t i = b; i < e; ++i)
+            {
+                parallel_for(0, 8, 1, [&visited, i](std::size_t b2, std::size_t e2) {
+                    for (std::size_t j = b2; j < e2; ++j)
+                    {
+                        ++visited[8 * i + j];
+                    }
+                });
+            }
+        });
+        EXPECT_EQ(std::vector<int>(64, 1), visited);
+    }
+
+    TEST(xexecution, work_stealing)
+    {
+        xthread_pool pool(2);
+        std::vector<std::atomic<int>> visited(512);
+        for (auto& v : visited)
+        {
+            v = 0;
+        }
+        pool.parallel_for(0, 8, 1, [&](std::size_t b, std::size_t e) {
+            for (std::size_t i = b; i < e; ++i)
+            {
+                pool.parallel_for(0, 8, 1, [&, i](std::size_t b2, std::size_t e2) {
+                    for (std::size_t j = b2; j < e2; ++j)
+                    {
+                        pool.parallel_for(0, 8, 1, [&, i, j](std::size_t b3, std::size_t e3) {
+                            for (std::size_t k = b3; k < e3; ++k)
+                            {
+                                ++visited[64 * i + 8 * j + k];
+                            }
+                        });
+                    }
+                });
+            }
+        });
+        for (const auto& v : visited)
+        {
+            EXPECT_EQ(1, v.load());
+        }
+    }
+
+    TEST(xexecution, nested_assign)
+    {
+        parallel_scope scope(3, 8);
+        xarray<double> a = arange<double>(64);
+        a.reshape({4, 16});
+        std::vector<xarray<double>> res(6);
+        parallel_for(0, res.size(), 1, [&](std::size_t b, std::size_t e) {
+            for (std::size_t i = b; i < e; ++i)
+            {
+                res[i] = a * double(i) + 1.;
+            }
+        });
+        for (std::size_t i = 0; i < res.size(); ++i)
+        {
+            EXPECT_EQ(xarray<double>(a * double(i) + 1.), res[i]);
+        }
+    }
+
+    TEST(xexecution, assign)
+    {
+        xarray<double> a = arange<double>(6000);
+        a.reshape({60, 100});
+        xarray<double> b = a * 0.5;
+        xarray<double> expected = 2. * a + b;
+
+        parallel_scope scope(4, 100);
+        xarray<double> res = 2. * a + b;
+        EXPECT_EQ(expected, res);
+
+        xtensor<double, 3> t({10, 6, 100});
+        xtensor<double, 3> te({10, 6, 100});
+        std::copy(a.begin(), a.end(), te.begin());
+        t = te + 1.;
+        te += 1.;
+        EXPECT_EQ(te, t);
+
+        res *= 3.;
+        EXPECT_EQ(expected * 3., res);
+
+        xarray<double> row = arange<double>(100);
+        xarray<double> bres = a + row;
+        execution_options::set_policy(execution_policy::sequential);
+        EXPECT_EQ(xarray<double>(a + row), bres);
+    }
+
+    TEST(xexecution, assign_stateful_functor)
+    {
+        xarray<double> a = arange<double>(6000);
+        a.reshape({60, 100});
+        xarray<double> expected = 2. * a;
+
+        parallel_scope scope(4, 100);
+        std::size_t count = 0;
+        auto f = vectorize(counting_fun{&count});
+        static_assert(!is_concurrently_readable<decltype(f(a))>::value, "stateful functors cannot be called concurrently");
+        static_assert(is_concurrently_readable<decltype(vectorize(reentrant_fun{2.})(a))>::value, "functors can opt in");
+        auto g = vectorize([](double x) { return x; });
+        static_assert(is_concurrently_readable<decltype(g(a))>::value, "stateless functors can be called concurrently");
+        xarray<double> res = f(a);
+        EXPECT_EQ(expected, res);
+        EXPECT_EQ(6000u, count);
+    }
+
+    TEST(xexecution, reducer)
+    {
+        xarray<double> a = arange<double>(6000);
+        a.reshape({10, 20, 30});
+        xarray<double> expected0 = sum(a, {1});
+        xarray<double> expected1 = sum(a, {0, 2});
+
+        parallel_scope scope(4, 60);
+        static_assert(has_assign_to<xarray<double>, decltype(sum(a, {1}))>::value, "reducers provide assign_to");
+        xarray<double> res0 = sum(a, {1});
+        xarray<double> res1 = sum(a, {0, 2});
+        EXPECT_EQ(expected0, res0);
+        EXPECT_EQ(expected1, res1);
+
+        xtensor<double, 2> t({10, 30});
+        t = sum(a, {1});
+        EXPECT_EQ(expected0, t);
+        res0 += sum(a, {1});
+        EXPECT_EQ(2. * expected0, res0);
+    }
+
+    TEST(xexecution, reducer_stateful_expression)
+    {
+        // Random generators share their engine, so reductions over them
+        // are evaluated by the calling thread, in the sequential order
+        random::seed(0);
+        xarray<double> expected = sum(random::rand<double>({2000, 200}), {1});
+
+        parallel_scope scope(4, 60);
+        xarray<double> a = arange<double>(6000);
+        static_assert(is_concurrently_readable<decltype(a + 1. * a)>::value, "functions of containers can be read concurrently");
+        static_assert(!is_concurrently_readable<decltype(random::rand<double>({2000, 200}))>::value, "random generators cannot be read concurrently");
+        random::seed(0);
+        xarray<double> res = sum(random::rand<double>({2000, 200}), {1});
+        EXPECT_EQ(expected, res);
+    }
+
+    TEST(xexecution, structured_assign)
+    {
+        xtensor<double, 2> a = random::randn<double>({256, 256});
+        xtensor<double, 2> ones_a = ones<double>({256, 256});
+        random::seed(0);
+        xtensor<double, 2> expected_rand = tril(random::rand<double>({256, 256}));
+        xtensor<double, 2> expected_prod = tril(ones_a) * random::rand<double>({256, 256});
+        xtensor<double, 2> expected = tril(a);
+
+        parallel_scope scope(4, 64);
+        static_assert(is_concurrently_readable<decltype(tril(a))>::value, "masks of containers can be read concurrently");
+        static_assert(!is_concurrently_readable<decltype(tril(random::rand<double>({2, 2})))>::value, "masks of random generators cannot");
+        xtensor<double, 2> res = tril(a);
+        EXPECT_EQ(expected, res);
+
+        // Random operands are evaluated by the calling thread
+        random::seed(0);
+        xtensor<double, 2> res_rand = tril(random::rand<double>({256, 256}));
+        xtensor<double, 2> res_prod = tril(ones_a) * random::rand<double>({256, 256});
+        EXPECT_EQ(expected_rand, res_rand);
+        EXPECT_EQ(expected_prod, res_prod);
+    }
+
+    TEST(xexecution, builders)
+    {
+        xarray<double> a = arange<double>(6000);
+        a.reshape({60, 100});
+        xarray<double> b = a + 6000.;
+        xarray<double> expected0 = concatenate(xtuple(a, b));
+        xarray<double> expected1 = stack(xtuple(a, b, a), 1);
+
+        parallel_scope scope(4, 100);
+        static_assert(has_assign_to<xarray<double>, decltype(concatenate(xtuple(a, b)))>::value, "builders provide assign_to");
+        xarray<double> res0 = concatenate(xtuple(a, b));
+        xarray<double> res1 = stack(xtuple(a, b, a), 1);
+        EXPECT_EQ(expected0, res0);
+        EXPECT_EQ(expected1, res1);
+        a.reshape({6000});
+        b.reshape({6000});
+        xarray<double> flat = concatenate(xtuple(a, b));
+        EXPECT_EQ(xarray<double>(arange<double>(12000)), flat);
+    }
+
+    TEST(xexecution, deterministic_reduction)
+    {
+        xarray<double> a = arange<double>(50000);
+        a.reshape({5, 10000});
+        a = sin(a) * 1e8 + cos(a * 0.1) * 1e-4;
+
+        double expected;
+        xarray<double> expected_axis;
+        {
+            parallel_scope scope(1, 1);
+            execution_options::set_deterministic_reduction(true);
+            execution_options::set_reduction_block_size(1000);
+            expected = sum(a)();
+            expected_axis = sum(a, {1});
+        }
+        for (std::size_t nb_threads : {2, 3, 4})
+        {
+            for (std::size_t grain : {500, 2000})
+            {
+                parallel_scope scope(nb_threads, grain);
+                execution_options::set_deterministic_reduction(true);
+                execution_options::set_reduction_block_size(1000);
+                EXPECT_EQ(expected, sum(a)());
+                xarray<double> res_axis = sum(a, {1});
+                EXPECT_EQ(expected_axis, res_axis);
+                EXPECT_EQ(expected / 50000., mean(a)());
+            }
+        }
+
+        // Reductions smaller than a block are plain accumulations
+        parallel_scope scope(4, 1);
+        execution_options::set_deterministic_reduction(true);
+        execution_options::set_reduction_block_size(100000);
+        double acc = std::accumulate(a.begin(), a.end(), 0.);
+        EXPECT_EQ(acc, sum(a)());
+
+        // Blocks of random generators are reduced by the calling thread
+        execution_options::set_reduction_block_size(100);
+        random::seed(0);
+        double expected_random = sum(random::rand<double>({100, 100}))();
+        {
+            parallel_scope sequential_scope(1, 1);
+            execution_options::set_deterministic_reduction(true);
+            execution_options::set_reduction_block_size(100);
+            random::seed(0);
+            EXPECT_EQ(expected_random, sum(random::rand<double>({100, 100}))());
+        }
+    }
+}
@@ -0,0 +1,188 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <fstream>
+#include <string>
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xfile_array.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xnoalias.hpp"
+#include "xtensor/xreducer.hpp"
+
+#include "test_files.hpp"
+
+namespace xt
+{
+    namespace
+    {
+        template <class T>
+        void write_raw(const std::string& path, const xarray<T>& a, const std::string& prefix = "")
+        {
+            std::ofstream out(path, std::ios::binary);
+            out.write(prefix.data(), static_cast<std::streamsize>(prefix.size()));
+            out.write(reinterpret_cast<const char*>(a.raw_data()), static_cast<std::streamsize>(a.size() * sizeof(T)));
+        }
+
+        std::string npy_header(const std::string& descr, bool fortran_order, const std::string& shape)
+        {
+            std::string dict = "{'descr': '" + descr + "', 'fortran_order': " +
+                (fortran_order ? "True" : "False") + ", 'shape': " + shape + ", }";
+            std::size_t total = 10 + dict.size() + 1;
+            dict.append((64 - total % 64) % 64, ' ');
+            dict.push_back('\n');
+            std::string header("\x93NUMPY\x01\x00", 8);
+            header.push_back(static_cast<char>(dict.size() & 0xFF));
+            header.push_back(static_cast<char>(dict.size() >> 8));
+            return header + dict;
+        }
+    }
+
+    TEST(xfile_array, raw)
+    {
+        xarray<double> a = arange<double>(24);
+        a.reshape({4, 6});
+        xarray<double> b = 3. * a + 1.;
+        temporary_file file_a("xfile_array_a.bin");
+        temporary_file file_b("xfile_array_b.bin");
+        write_raw(file_a.path(), a);
+        write_raw(file_b.path(), b);
+
+        auto fa = open_raw_file<double>(file_a.path(), {4, 6});
+        auto fb = open_raw_file<double>(file_b.path(), {4, 6});
+        fa.set_window_size(5);
+        fb.set_window_size(7);
+        EXPECT_EQ(a(2, 3), fa(2, 3));
+        EXPECT_EQ(b(3, 5), fb(3, 5));
+
+        xarray<double> res(a.shape());
+        noalias(res) = fa * 2. + fb;
+        EXPECT_EQ(a * 2. + b, res);
+
+        xarray<double> sres = sum(fa, {1});
+        EXPECT_EQ(sum(a, {1})(), sres());
+        EXPECT_EQ(xarray<double>(sum(a, {1})), sres);
+
+        xarray<double> row = {1., 2., 3., 4., 5., 6.};
+        temporary_file file_row("xfile_array_row.bin");
+        write_raw(file_row.path(), row);
+        auto frow = open_raw_file<double>(file_row.path(), {6});
+        xarray<double> bres = fa + frow;
+        EXPECT_EQ(a + row, bres);
+    }
+
+    TEST(xfile_array, npy)
+    {
+        xarray<int, layout::dynamic> a({3, 4}, layout::column_major);
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            for (std::size_t j = 0; j < 4; ++j)
+            {
+                a(i, j) = int(10 * i + j);
+            }
+        }
+        std::string descr = std::string(1, detail::is_little_endian() ? '<' : '>') + "i" + std::to_string(sizeof(int));
+        temporary_file file("xfile_array.npy");
+        std::ofstream out(file.path(), std::ios::binary);
+        std::string header = npy_header(descr, true, "(3, 4)");
+        out.write(header.data(), static_cast<std::streamsize>(header.size()));
+        out.write(reinterpret_cast<const char*>(a.raw_data()), static_cast<std::streamsize>(a.size() * sizeof(int)));
+        out.close();
+
+        auto fa = open_npy_file<int>(file.path());
+        EXPECT_EQ(layout::column_major, fa.layout());
+        EXPECT_EQ(a.shape(), fa.shape());
+        fa.set_window_size(4);
+        xarray<int> res = fa;
+        EXPECT_EQ(a, res);
+        EXPECT_EQ(23, fa(2, 3));
+
+        EXPECT_ANY_THROW(open_npy_file<double>(file.path()));
+    }
+
+    TEST(xfile_array, read_count)
+    {
+        xarray<double, layout::dynamic> a({6, 8}, layout::column_major);
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            a.data()[i] = double(i);
+        }
+        temporary_file file("xfile_array_count.bin");
+        std::ofstream out(file.path(), std::ios::binary);
+        out.write(reinterpret_cast<const char*>(a.raw_data()), static_cast<std::streamsize>(a.size() * sizeof(double)));
+        out.close();
+
+        // A row-major traversal of the column-major file reads each window once
+        auto fa = open_raw_file<double>(file.path(), {6, 8}, layout::column_major);
+        fa.set_window_size(8);
+        xarray<double> res = fa;
+        EXPECT_EQ(a, res);
+        EXPECT_EQ(6u, fa.read_count());
+
+        xarray<double> sres = sum(fa, {0});
+        EXPECT_EQ(xarray<double>(sum(a, {0})), sres);
+        EXPECT_EQ(12u, fa.read_count());
+
+        // Backward steps stay in the aligned window; entering it also
+        // prefetches the following one
+        auto st = fa.stepper_begin(fa.shape());
+        st.step(0, 5);
+        st.step(1, 1);
+        EXPECT_EQ(a(5, 1), *st);
+        for (std::size_t i = 0; i < 5; ++i)
+        {
+            st.step_back(0);
+            EXPECT_EQ(a(4 - i, 1), *st);
+        }
+        EXPECT_EQ(15u, fa.read_count());
+
+        // With a single window, the strided traversal reloads it
+        fa.set_window_count(1);
+        res = fa;
+        EXPECT_EQ(a, res);
+        EXPECT_LT(18u, fa.read_count());
+    }
+
+    TEST(xfile_array, prefetch)
+    {
+        xarray<double> a = arange<double>(48);
+        temporary_file file("xfile_array_prefetch.bin");
+        write_raw(file.path(), a);
+
+        auto fa = open_raw_file<double>(file.path(), {48});
+        fa.set_window_size(8);
+        auto st = fa.stepper_begin(fa.shape());
+        EXPECT_EQ(0., *st);
+        // The next window is requested as soon as the stepper enters one
+        EXPECT_EQ(2u, fa.read_count());
+        st.step(0, 7);
+        EXPECT_EQ(7., *st);
+        EXPECT_EQ(2u, fa.read_count());
+        st.step(0, 1);
+        EXPECT_EQ(8., *st);
+        EXPECT_EQ(3u, fa.read_count());
+
+        // Moving backward prefetches the previous window
+        auto rst = fa.stepper_begin(fa.shape());
+        rst.step(0, 47);
+        EXPECT_EQ(47., *rst);
+        EXPECT_EQ(4u, fa.read_count());
+        rst.step_back(0, 8);
+        EXPECT_EQ(39., *rst);
+        EXPECT_EQ(6u, fa.read_count());
+        rst.step_back(0, 8);
+        EXPECT_EQ(31., *rst);
+        EXPECT_EQ(7u, fa.read_count());
+
+        xarray<double> res = fa * 2.;
+        EXPECT_EQ(a * 2., res);
+    }
+}
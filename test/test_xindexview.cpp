@@ -7,9 +7,17 @@
 ****************************************************************************/
 
 #include "gtest/gtest.h"
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
 #include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
 #include "xtensor/xrandom.hpp"
 #include "xtensor/xindexview.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xtensor.hpp"
 #include "xtensor/xbroadcast.hpp"
 #include "xtensor/xview.hpp"
 #include "test_common.hpp"
@@ -111,6 +119,42 @@ namespace xt
         EXPECT_EQ(100, v(2));
     }
     
+    TEST(xindexview, gather_scatter)
+    {
+        xarray<double> a = arange<double>(3000);
+        a.reshape({100, 30});
+        std::vector<xindex> indices;
+        for (size_t i = 0; i < 500; ++i)
+        {
+            indices.push_back({(i * 37) % 100, (i * 11) % 30});
+        }
+        auto v = index_view(a, indices);
+        EXPECT_TRUE(decltype(v)::has_offsets);
+        static_assert(has_assign_to<xarray<double>, decltype(v)>::value, "index views on containers are gathered");
+
+        xarray<double> g = v;
+        xtensor<double, 1> gt = v;
+        for (size_t i = 0; i < indices.size(); ++i)
+        {
+            EXPECT_EQ(a(indices[i][0], indices[i][1]), g(i));
+        }
+        EXPECT_EQ(g, gt);
+
+        xarray<double> b = zeros<double>({100, 30});
+        auto w = index_view(b, indices);
+        w = g + 1.;
+        EXPECT_EQ(a(37, 11) + 1., b(37, 11));
+        EXPECT_EQ(0., b(0, 1));
+
+        // Indices on views are offsets in the buffer of the container
+        auto sv = view(a, range(10, 20), range(0, 30, 2));
+        auto vv = index_view(sv, {{1, 2}, {3, 4}});
+        EXPECT_TRUE(decltype(vv)::has_offsets);
+        EXPECT_EQ(a(11, 4), vv(0));
+        vv = 0.;
+        EXPECT_EQ(0., a(13, 8));
+    }
+
     TEST(xindexview, filtration)
     {
         xarray<double> a = {{ 1, 5, 3 }, { 4, 5, 6 }};
@@ -118,4 +162,34 @@ namespace xt
         xarray<double> expected = {{ 1, 7, 3}, {4, 7, 8 }};
         EXPECT_EQ(expected, a);
     }
+
+    TEST(xindexview, compaction)
+    {
+        xarray<double> a = arange<double>(-500., 500.);
+        a.reshape({10, 100});
+        a = sin(a);
+        auto f = filter(a, a > 0.);
+        xarray<double> res = f;
+        std::vector<double> expected;
+        std::copy_if(a.cbegin(), a.cend(), std::back_inserter(expected), [](double v) { return v > 0.; });
+        EXPECT_TRUE(std::equal(expected.cbegin(), expected.cend(), res.cbegin()));
+        EXPECT_EQ(expected.size(), res.size());
+
+        // Views are compacted through their strides, in row-major order
+        auto v = view(a, range(0, 10, 2), range(99, 0, -3));
+        xarray<double> rv = filter(v, v < 0.);
+        xarray<double> ev = v;
+        std::vector<double> expected_v;
+        std::copy_if(ev.cbegin(), ev.cend(), std::back_inserter(expected_v), [](double x) { return x < 0.; });
+        EXPECT_TRUE(std::equal(expected_v.cbegin(), expected_v.cend(), rv.cbegin()));
+        EXPECT_EQ(expected_v.size(), rv.size());
+
+        xarray<bool, layout::column_major> mask = a > 0.;
+        xarray<double> rm = filter(a, mask);
+        EXPECT_EQ(res, rm);
+
+        filtration(a, a < 0.) = 0.;
+        EXPECT_EQ(0., amin(a)());
+        EXPECT_EQ(res.size(), size_t(std::count_if(a.cbegin(), a.cend(), [](double x) { return x > 0.; })));
+    }
 }
\ No newline at end of file
@@ -19,6 +19,7 @@
 #include "xtensor/xrandom.hpp"
 #include "xtensor/xbuilder.hpp"
 #include "xtensor/xview.hpp"
+#include "xtensor/xvectorize.hpp"
 
 #include "files/xio_expected_results.hpp"
 
@@ -266,5 +267,16 @@ namespace xt
 
         EXPECT_EQ(custom_formatter_result, out.str());
     }
-}
 
+    TEST(xio, lazy_summarized)
+    {
+        std::size_t count = 0;
+        auto counted = vectorize([&count](int v) { ++count; return v; });
+        auto e = counted(xt::ones<int>({7, 1000}));
+
+        std::stringstream out;
+        out << e;
+        EXPECT_EQ(cut_both, out.str());
+        EXPECT_EQ(36u, count);
+    }
+}
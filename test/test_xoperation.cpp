@@ -10,6 +10,9 @@
 
 #include <cstddef>
 #include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
 
 namespace xt
 {
@@ -234,6 +237,44 @@ namespace xt
         EXPECT_EQ(false, all(b));
     }
 
+    TEST(operation, any_all_axes)
+    {
+        xarray<int> b = {{0, 2, 1}, {0, 1, 0}};
+        xarray<bool> any0 = any(b, {0});
+        xarray<bool> all1 = all(b, {1});
+        EXPECT_EQ(xarray<bool>({false, true, true}), any0);
+        EXPECT_EQ(xarray<bool>({false, false}), all1);
+        xarray<bool> all0 = all(b > -1, {0});
+        EXPECT_EQ(xarray<bool>({true, true, true}), all0);
+
+        // Large containers and expressions are tested by blocks
+        xarray<double> c = arange<double>(20000);
+        EXPECT_TRUE(any(c));
+        EXPECT_FALSE(all(c));
+        EXPECT_TRUE(all(c >= 0.));
+        EXPECT_FALSE(any(c > 19999.));
+        c(19999) = 30000.;
+        EXPECT_TRUE(any(c > 19999.));
+        auto v = view(c, range(10000, 20000));
+        EXPECT_TRUE(any(v > 29999.));
+        EXPECT_FALSE(all(v > 10000.));
+    }
+
+    TEST(operation, count_nonzero)
+    {
+        xarray<int> b = {{0, 2, 1}, {2, 1, 0}};
+        EXPECT_EQ(4u, count_nonzero(b));
+        EXPECT_EQ(2u, count_nonzero(b > 1));
+        xarray<size_t> c0 = count_nonzero(b, {0});
+        xarray<size_t> c1 = count_nonzero(b, {1});
+        EXPECT_EQ(xarray<size_t>({1, 2, 1}), c0);
+        EXPECT_EQ(xarray<size_t>({2, 2}), c1);
+
+        xarray<double> big = arange<double>(-5000., 15000.);
+        EXPECT_EQ(19999u, count_nonzero(big));
+        EXPECT_EQ(5000u, count_nonzero(big < 0.));
+    }
+
     TEST(operation, nonzero)
     {
         xarray<int> a = {1, 0, 3};
@@ -264,5 +305,45 @@ namespace xt
         std::vector<xindex> expected = {{0, 0}, {1, 1}, {2, 2}};
         EXPECT_EQ(expected, where(a));
     }
+
+    TEST(operation, flatnonzero)
+    {
+        xarray<int> b = {{0, 2, 1}, {2, 1, 0}};
+        std::vector<size_t> expected = {1, 2, 3, 4};
+        EXPECT_EQ(expected, flatnonzero(b));
+
+        xarray<int, layout::column_major> bc = b;
+        EXPECT_EQ(expected, flatnonzero(bc));
+        auto t = view(b, all(), range(2, 0, -1));
+        std::vector<size_t> expected_t = {0, 1, 3};
+        EXPECT_EQ(expected_t, flatnonzero(t));
+        EXPECT_EQ(expected_t, flatnonzero(t > 0));
+
+        xarray<double> big = arange<double>(10000);
+        big.reshape({100, 100});
+        auto nz = flatnonzero(big > 9000.);
+        EXPECT_EQ(999u, nz.size());
+        EXPECT_EQ(9001u, nz.front());
+        EXPECT_EQ(9999u, nz.back());
+    }
+
+    TEST(operation, argwhere)
+    {
+        xarray<int> b = {{0, 2, 1}, {2, 1, 0}};
+        xtensor<size_t, 2> expected = {{0, 1}, {0, 2}, {1, 0}, {1, 1}};
+        EXPECT_EQ(expected, argwhere(b));
+
+        xarray<int> z = {0, 0};
+        auto az = argwhere(z);
+        EXPECT_EQ(0u, az.shape()[0]);
+        EXPECT_EQ(1u, az.shape()[1]);
+
+        xarray<double> big = arange<double>(24000);
+        big.reshape({20, 30, 40});
+        auto aw = argwhere(big >= 23998.);
+        xtensor<size_t, 2> expected_big = {{19, 29, 38}, {19, 29, 39}};
+        EXPECT_EQ(expected_big, aw);
+        EXPECT_EQ(nonzero(big >= 23998.)[1], xindex({19, 29, 39}));
+    }
 }
 
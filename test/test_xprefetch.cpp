@@ -0,0 +1,87 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <fstream>
+#include <string>
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xprefetch.hpp"
+#include "xtensor/xview.hpp"
+
+#include "test_files.hpp"
+
+namespace xt
+{
+    namespace
+    {
+        xarray<double> write_prefetch_file(const std::string& path)
+        {
+            xarray<double> a = arange<double>(70);
+            a.reshape({10, 7});
+            std::ofstream out(path, std::ios::binary);
+            out.write(reinterpret_cast<const char*>(a.raw_data()), static_cast<std::streamsize>(a.size() * sizeof(double)));
+            return a;
+        }
+    }
+
+    TEST(xprefetch, chunks)
+    {
+        temporary_file file("xprefetch.bin");
+        xarray<double> a = write_prefetch_file(file.path());
+        xprefetch_reader<double, 2> reader(file.path(), {10, 7}, 3, 3);
+        EXPECT_EQ(4u, reader.nb_chunks());
+        EXPECT_EQ(3u, reader.nb_buffers());
+
+        std::size_t row = 0;
+        for (const auto& chunk : reader)
+        {
+            std::size_t rows = chunk.shape()[0];
+            EXPECT_EQ(row + rows == 10 ? 1u : 3u, rows);
+            xarray<double> expected = view(a, range(row, row + rows), all());
+            EXPECT_EQ(expected, chunk);
+            row += rows;
+        }
+        EXPECT_EQ(10u, row);
+    }
+
+    TEST(xprefetch, file_array)
+    {
+        temporary_file file("xprefetch_fa.bin");
+        xarray<double> a = write_prefetch_file(file.path());
+        auto fa = open_raw_file<double>(file.path(), {10, 7});
+        auto reader = make_prefetch_reader<2>(fa, 4);
+        double total = 0.;
+        for (auto it = reader.begin(); it != reader.end(); ++it)
+        {
+            total += sum(*it)();
+        }
+        EXPECT_EQ(sum(a)(), total);
+    }
+
+    TEST(xprefetch, early_stop)
+    {
+        temporary_file file("xprefetch_stop.bin");
+        write_prefetch_file(file.path());
+        xprefetch_reader<double, 2> reader(file.path(), {10, 7}, 1);
+        auto it = reader.begin();
+        EXPECT_EQ(0., (*it)(0, 0));
+        ++it;
+        EXPECT_EQ(7., (*it)(0, 0));
+    }
+
+    TEST(xprefetch, errors)
+    {
+        temporary_file file("xprefetch_missing.bin");
+        xprefetch_reader<double, 2> reader(file.path(), {10, 7}, 3);
+        EXPECT_THROW(*reader.begin(), std::runtime_error);
+    }
+}
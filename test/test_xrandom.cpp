@@ -7,8 +7,14 @@
 ****************************************************************************/
 
 #include "gtest/gtest.h"
+#include <algorithm>
+#include <thread>
 #include "xtensor/xrandom.hpp"
 #include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
 
 namespace xt
 {
@@ -47,4 +53,185 @@ namespace xt
         ASSERT_NE(p1, p2);
         ASSERT_NE(p1, p3);
     }
+
+    TEST(xrandom, philox)
+    {
+        // Known answers of the Philox4x32-10 reference implementation
+        random::philox4x32 zero(0);
+        random::philox4x32::block_type expected0 = {{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}};
+        EXPECT_EQ(expected0, zero.block(0));
+        random::philox4x32 ones(0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF);
+        random::philox4x32::block_type expected1 = {{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}};
+        EXPECT_EQ(expected1, ones.block(0xFFFFFFFFFFFFFFFF));
+
+        EXPECT_EQ(expected0[0], zero());
+        zero.discard(6);
+        EXPECT_EQ(zero.block(1)[3], zero());
+        EXPECT_EQ(2u, zero.counter());
+    }
+
+    TEST(xrandom, counter_based)
+    {
+        random::philox4x32 engine(42);
+        auto r = random::rand<double>({20, 30}, 0., 1., engine);
+        xarray<double> a = r;
+        xarray<double> b = r;
+        EXPECT_EQ(a, b);
+        EXPECT_TRUE(all(a >= 0.) && all(a < 1.));
+
+        // Elements only depend on the seed and their index
+        random::philox4x32 engine2(42);
+        auto r2 = random::rand<double>({20, 30}, 0., 1., engine2);
+        xarray<double> part = view(r2, range(5, 12), all());
+        EXPECT_EQ(xarray<double>(view(a, range(5, 12), all())), part);
+        EXPECT_EQ(a(13, 7), r2(13, 7));
+
+        // Missing indices map onto the leading dimensions, extra ones are dropped
+        EXPECT_EQ(a(1, 0), r2(1));
+        EXPECT_EQ(a(4, 2), r2(3, 4, 2));
+
+        xarray<double> next = random::rand<double>({20, 30}, 0., 1., engine);
+        EXPECT_NE(a, next);
+
+        xarray<int> i = random::randint<int>({100}, -3, 4, engine);
+        EXPECT_TRUE(all(i >= -3) && all(i < 4));
+        xarray<double> n = random::randn<double>({1000}, 2., 0.5, engine);
+        EXPECT_NEAR(2., mean(n)(), 0.1);
+    }
+
+    TEST(xrandom, per_thread_engine)
+    {
+        random::default_engine_type* other = nullptr;
+        std::thread t([&other]() { other = &random::get_default_random_engine(); });
+        t.join();
+        EXPECT_NE(&random::get_default_random_engine(), other);
+    }
+
+    TEST(xrandom, block_fill)
+    {
+        // Contiguous destinations are filled in block, strided ones element-wise,
+        // both drawing the same sequence
+        random::seed(7);
+        xarray<double> a = random::rand<double>({40, 30}, -1., 1.);
+        random::seed(7);
+        xarray<double> b = zeros<double>({40, 30});
+        auto vb = view(b, all(), all());
+        vb = random::rand<double>({40, 30}, -1., 1.);
+        EXPECT_EQ(a, b);
+        EXPECT_TRUE(all(a >= -1.) && all(a < 1.));
+
+        random::seed(7);
+        xtensor<float, 2> f = random::rand<float>({40, 30});
+        EXPECT_TRUE(all(f >= 0.f) && all(f < 1.f));
+
+        random::seed(3);
+        xarray<int> i = random::randint<int>({100}, 0, 10);
+        random::seed(3);
+        xarray<int> j = zeros<int>({100});
+        auto vj = view(j, all());
+        vj = random::randint<int>({100}, 0, 10);
+        EXPECT_EQ(i, j);
+
+        random::philox4x32 engine(5);
+        auto r = random::randn<double>({50, 20}, 0., 1., engine);
+        xarray<double> n = r;
+        EXPECT_EQ(r(31, 7), n(31, 7));
+        EXPECT_EQ(r(0, 0), n(0, 0));
+    }
+
+    TEST(xrandom, distributions)
+    {
+        random::seed(11);
+        xarray<double> e = random::exponential<double>({20000}, 4.);
+        EXPECT_TRUE(all(e >= 0.));
+        EXPECT_NEAR(0.25, mean(e)(), 0.02);
+
+        xarray<double> g = random::gamma<double>({20000}, 3., 2.);
+        EXPECT_NEAR(6., mean(g)(), 0.2);
+
+        xarray<int> b = random::binomial<int>({20000}, 10, 0.3);
+        EXPECT_TRUE(all(b >= 0) && all(b <= 10));
+        EXPECT_NEAR(3., double(sum(b)()) / 20000., 0.1);
+
+        xarray<int> p = random::poisson<int>({20000}, 5.);
+        EXPECT_NEAR(5., double(sum(p)()) / 20000., 0.15);
+
+        // Rejection samplers stay independent of the evaluation order
+        random::philox4x32 engine(9);
+        auto r = random::gamma<double>({100, 10}, 0.5, 1., engine);
+        xarray<double> gr = r;
+        EXPECT_EQ(r(73, 4), gr(73, 4));
+        EXPECT_EQ(r(0, 0), gr(0, 0));
+        EXPECT_NE(gr(0, 0), gr(0, 1));
+        xarray<double> er = random::exponential<double>({1000}, 1., engine);
+        EXPECT_NEAR(1., mean(er)(), 0.15);
+    }
+
+    TEST(xrandom, shuffle)
+    {
+        xarray<int> a = arange<int>(24);
+        a.reshape({4, 6});
+        xarray<int> sorted = a;
+
+        random::seed(2);
+        random::shuffle(a);
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            // Rows are permuted, their content is kept
+            int first = a(i, 0);
+            EXPECT_EQ(0, first % 6);
+            for (std::size_t j = 0; j < 6; ++j)
+            {
+                EXPECT_EQ(first + int(j), a(i, j));
+            }
+        }
+        EXPECT_NE(sorted, a);
+
+        xarray<int> c = sorted;
+        random::shuffle(c, 1);
+        for (std::size_t j = 0; j < 6; ++j)
+        {
+            for (std::size_t i = 0; i < 4; ++i)
+            {
+                EXPECT_EQ(c(0, j) + 6 * int(i), c(i, j));
+            }
+        }
+        EXPECT_THROW(random::shuffle(c, 2), std::runtime_error);
+
+        auto p = random::permutation(100);
+        std::sort(p.begin(), p.end());
+        EXPECT_EQ((xtensor<int, 1>(arange<int>(100))), p);
+
+        xarray<int> q = random::permutation(sorted, 1);
+        EXPECT_EQ(sum(sorted)(), sum(q)());
+        EXPECT_EQ(sorted.shape(), q.shape());
+    }
+
+    TEST(xrandom, choice)
+    {
+        xarray<double> pop = arange<double>(10.);
+        random::seed(4);
+        auto c = random::choice(pop, 1000);
+        EXPECT_EQ(1000u, c.size());
+        EXPECT_TRUE(all(c >= 0.) && all(c < 10.));
+
+        auto u = random::choice(pop, 10, false);
+        std::sort(u.begin(), u.end());
+        EXPECT_EQ((xtensor<double, 1>(pop)), u);
+        EXPECT_THROW(random::choice(pop, 11, false), std::runtime_error);
+
+        xarray<double> w = zeros<double>({10});
+        w(2) = 1.;
+        w(7) = 3.;
+        auto cw = random::choice(pop, 4000, w);
+        EXPECT_TRUE(all(equal(cw, 2.) || equal(cw, 7.)));
+        EXPECT_NEAR(3000., double(std::count(cw.begin(), cw.end(), 7.)), 150.);
+
+        auto cu = random::choice(pop, 2, w, false);
+        std::sort(cu.begin(), cu.end());
+        EXPECT_EQ(2., cu(0));
+        EXPECT_EQ(7., cu(1));
+        EXPECT_THROW(random::choice(pop, 3, w, false), std::runtime_error);
+        EXPECT_THROW(random::choice(pop, 3, zeros<double>({10})), std::runtime_error);
+    }
 }
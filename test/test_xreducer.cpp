@@ -7,6 +7,8 @@
 ****************************************************************************/
 
 #include "gtest/gtest.h"
+#include <thread>
+#include <vector>
 #include "xtensor/xarray.hpp"
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xbuilder.hpp"
@@ -110,4 +112,35 @@ namespace xt
         EXPECT_TRUE(all(equal(mean0, expect0)));
         EXPECT_TRUE(all(equal(mean1, expect1)));
     }
+
+    TEST(xreducer, concurrent_evaluation)
+    {
+        xarray<double> a = arange<double>(600);
+        a.reshape({20, 30});
+        auto red = sum(a, {1});
+        xarray<double> expected = red;
+
+        std::vector<xarray<double>> res(4, zeros<double>({20}));
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < res.size(); ++t)
+        {
+            threads.emplace_back([&red, &res, t]() {
+                for (std::size_t k = 0; k < 50; ++k)
+                {
+                    for (std::size_t i = 0; i < 20; ++i)
+                    {
+                        res[t](i) = red(i);
+                    }
+                }
+            });
+        }
+        for (auto& th : threads)
+        {
+            th.join();
+        }
+        for (const auto& r : res)
+        {
+            EXPECT_EQ(expected, r);
+        }
+    }
 }
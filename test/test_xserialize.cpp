@@ -0,0 +1,102 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <complex>
+#include <sstream>
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xmissing.hpp"
+#include "xtensor/xserialize.hpp"
+#include "xtensor/xtensor.hpp"
+
+namespace xt
+{
+    TEST(xserialize, xarray)
+    {
+        xarray<double> a = {{1., 2., 3.}, {4., 5., 6.}};
+        std::stringstream stream;
+        serialize(stream, a);
+
+        xarray<double> res;
+        deserialize(stream, res);
+        EXPECT_EQ(a, res);
+        EXPECT_EQ(a.shape(), res.shape());
+    }
+
+    TEST(xserialize, xtensor)
+    {
+        xtensor<std::complex<float>, 3> a = {{{1.f, 2.f}, {3.f, 4.f}}, {{5.f, 6.f}, {7.f, 8.f}}};
+        a(1, 0, 1) = std::complex<float>(1.f, -1.f);
+        std::stringstream stream;
+        serialize(stream, a);
+        auto res = deserialize<xtensor<std::complex<float>, 3>>(stream);
+        EXPECT_EQ(a, res);
+
+        std::stringstream stream2;
+        serialize(stream2, a);
+        xtensor<std::complex<float>, 2> wrong_dim;
+        EXPECT_THROW(deserialize(stream2, wrong_dim), std::runtime_error);
+    }
+
+    TEST(xserialize, layout)
+    {
+        xarray<int, layout::dynamic> a({3, 4}, layout::column_major);
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            for (std::size_t j = 0; j < 4; ++j)
+            {
+                a(i, j) = int(10 * i + j);
+            }
+        }
+        std::stringstream stream;
+        serialize(stream, a);
+        std::string buffer = stream.str();
+
+        std::stringstream dynamic_stream(buffer);
+        xarray<int, layout::dynamic> dyn;
+        deserialize(dynamic_stream, dyn);
+        EXPECT_EQ(layout::column_major, dyn.layout());
+        EXPECT_EQ(a, dyn);
+
+        std::stringstream row_major_stream(buffer);
+        xarray<int> rm;
+        deserialize(row_major_stream, rm);
+        EXPECT_EQ(layout::row_major, rm.layout());
+        EXPECT_EQ(a, rm);
+    }
+
+    TEST(xserialize, optional)
+    {
+        xarray_optional<double> a = {{1., 2., missing<double>()}, {4., missing<double>(), 6.}};
+        std::stringstream stream;
+        serialize(stream, a);
+        xarray_optional<double> res;
+        deserialize(stream, res);
+        EXPECT_EQ(a.shape(), res.shape());
+        EXPECT_EQ(a(0, 1), res(0, 1));
+        EXPECT_FALSE(res(0, 2).has_value());
+        EXPECT_FALSE(res(1, 1).has_value());
+        EXPECT_TRUE(res(1, 2).has_value());
+    }
+
+    TEST(xserialize, errors)
+    {
+        xarray<double> a = {1., 2., 3.};
+        std::stringstream stream;
+        serialize(stream, a);
+        xarray<float> wrong_type;
+        EXPECT_THROW(deserialize(stream, wrong_type), std::runtime_error);
+
+        std::string truncated = stream.str().substr(0, 30);
+        std::stringstream truncated_stream(truncated);
+        xarray<double> res;
+        EXPECT_THROW(deserialize(truncated_stream, res), std::runtime_error);
+    }
+}
@@ -72,4 +72,81 @@ namespace xt
             EXPECT_EQ(double(i), a[i]);
         }
     }
-}
\ No newline at end of file
+
+    using small_vector_type = svector<std::size_t, 4>;
+
+    TEST(svector, constructor)
+    {
+        small_vector_type a;
+        EXPECT_EQ(0u, a.size());
+        EXPECT_TRUE(a.on_stack());
+
+        small_vector_type b(3, 2);
+        EXPECT_EQ(3u, b.size());
+        EXPECT_EQ(2u, b[2]);
+        EXPECT_TRUE(b.on_stack());
+
+        std::vector<std::size_t> src = {1, 2, 3, 4, 5, 6};
+        small_vector_type c(src.cbegin(), src.cend());
+        EXPECT_EQ(6u, c.size());
+        EXPECT_FALSE(c.on_stack());
+        EXPECT_TRUE(std::equal(src.cbegin(), src.cend(), c.cbegin()));
+
+        small_vector_type d = {4, 3, 2};
+        EXPECT_EQ(4u, d.front());
+        EXPECT_EQ(2u, d.back());
+    }
+
+    TEST(svector, copy_move)
+    {
+        small_vector_type a = {1, 2, 3};
+        small_vector_type b = {1, 2, 3, 4, 5};
+
+        small_vector_type ca(a);
+        small_vector_type cb(b);
+        EXPECT_EQ(a, ca);
+        EXPECT_EQ(b, cb);
+        ca = cb;
+        EXPECT_EQ(b, ca);
+        cb = a;
+        EXPECT_EQ(a, cb);
+
+        small_vector_type ma(std::move(ca));
+        EXPECT_EQ(b, ma);
+        EXPECT_FALSE(ma.on_stack());
+        EXPECT_TRUE(ca.empty());
+        ma = std::move(cb);
+        EXPECT_EQ(a, ma);
+
+        swap(ma, b);
+        EXPECT_EQ(5u, ma.size());
+        EXPECT_EQ(a, b);
+        EXPECT_TRUE(a < ma);
+    }
+
+    TEST(svector, modifiers)
+    {
+        small_vector_type a;
+        for (std::size_t i = 0; i < 10; ++i)
+        {
+            a.push_back(i);
+            EXPECT_EQ(i + 1, a.size());
+            EXPECT_EQ(i, a.back());
+        }
+        EXPECT_FALSE(a.on_stack());
+        EXPECT_LE(10u, a.capacity());
+
+        a.erase(a.begin() + 2);
+        EXPECT_EQ(9u, a.size());
+        EXPECT_EQ(3u, a[2]);
+        a.pop_back();
+        EXPECT_EQ(8u, a.back());
+
+        a.resize(12, 7);
+        EXPECT_EQ(7u, a[11]);
+        a.resize(2);
+        EXPECT_EQ((small_vector_type{0, 1}), a);
+        a.clear();
+        EXPECT_TRUE(a.empty());
+    }
+}
@@ -0,0 +1,270 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille and Sylvain Corlay                     *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <numeric>
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xstrided_view.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    using std::size_t;
+
+    TEST(xstrided_view, access)
+    {
+        xarray<double> a = arange<double>(12);
+        a.reshape({3, 4});
+        // Every other column, last row first
+        auto v = strided_view(a, std::vector<size_t>({3, 2}), std::vector<std::ptrdiff_t>({-4, 2}), 8);
+        EXPECT_EQ(v.layout(), layout::dynamic);
+        EXPECT_EQ(2u, v.dimension());
+        EXPECT_EQ(6u, v.size());
+        EXPECT_EQ(-4, v.strides()[0]);
+        EXPECT_EQ(8u, v.raw_data_offset());
+        EXPECT_EQ(8., v(0, 0));
+        EXPECT_EQ(10., v(0, 1));
+        EXPECT_EQ(2., v(2, 1));
+        EXPECT_EQ(4., v(1));
+        xindex idx = {1, 1};
+        EXPECT_EQ(6., v[idx]);
+        EXPECT_EQ(6., v.element(idx.cbegin(), idx.cend()));
+
+        xarray<double> expected = {{8., 10.}, {4., 6.}, {0., 2.}};
+        EXPECT_EQ(expected, xarray<double>(v));
+        EXPECT_TRUE(std::equal(v.cbegin(), v.cend(), expected.cbegin()));
+
+        v(2, 1) = -1.;
+        EXPECT_EQ(-1., a(0, 2));
+    }
+
+    TEST(xstrided_view, flip)
+    {
+        xtensor<double, 3> a = {{{0., 1., 2.}, {3., 4., 5.}}, {{6., 7., 8.}, {9., 10., 11.}}};
+        auto f0 = flip(a, 0);
+        auto f2 = flip(a, 2);
+        EXPECT_EQ(-6, f0.strides()[0]);
+        EXPECT_EQ(-1, f2.strides()[2]);
+
+        xtensor<double, 3> e0 = {{{6., 7., 8.}, {9., 10., 11.}}, {{0., 1., 2.}, {3., 4., 5.}}};
+        xtensor<double, 3> e2 = {{{2., 1., 0.}, {5., 4., 3.}}, {{8., 7., 6.}, {11., 10., 9.}}};
+        xtensor<double, 3> r0 = f0;
+        xtensor<double, 3> r2 = f2;
+        EXPECT_EQ(e0, r0);
+        EXPECT_EQ(e2, r2);
+        EXPECT_TRUE(std::equal(f2.cbegin(), f2.cend(), e2.cbegin()));
+
+        // Broadcasting and arithmetic go through the stepper
+        xtensor<double, 3> s = f2 + a;
+        EXPECT_EQ((xtensor<double, 3>(e2 + a)), s);
+        xarray<double> row = {1., 2., 3.};
+        xarray<double> b = f2 * row;
+        EXPECT_EQ(xarray<double>(e2 * row), b);
+
+        // Flipping twice gives back the original elements
+        xtensor<double, 3> twice = flip(flip(xtensor<double, 3>(a), 1), 1);
+        EXPECT_EQ(a, twice);
+
+        // Flipped views are lvalues
+        xarray<double> c = arange<double>(6);
+        flip(c, 0) = arange<double>(6);
+        EXPECT_EQ(xarray<double>({5., 4., 3., 2., 1., 0.}), c);
+        auto fc = flip(c, 0);
+        fc += 1.;
+        EXPECT_EQ(xarray<double>({6., 5., 4., 3., 2., 1.}), c);
+        c = flip(c, 0);
+        EXPECT_EQ(xarray<double>({1., 2., 3., 4., 5., 6.}), c);
+
+        xarray<double> z(std::vector<size_t>({0, 3}));
+        xarray<double> zr = flip(z, 0);
+        EXPECT_EQ(0u, zr.size());
+        auto fz = flip(z, 1);
+        EXPECT_TRUE(fz.cbegin() == fz.cend());
+
+        const xarray<double>& cc = c;
+        auto fcc = flip(cc, 0);
+        EXPECT_EQ(6., *fcc.begin());
+    }
+
+    TEST(xstrided_view, reversed_slices)
+    {
+        using namespace xt::placeholders;
+        xarray<double> a = arange<double>(24);
+        a.reshape({4, 6});
+        auto v = view(a, range(_, _, -1), range(5, _, -2));
+        xarray<double> expected = {{23., 21., 19.}, {17., 15., 13.}, {11., 9., 7.}, {5., 3., 1.}};
+        xarray<double> res = v;
+        EXPECT_EQ(expected, res);
+        EXPECT_TRUE(std::equal(v.cbegin(), v.cend(), expected.cbegin()));
+    }
+
+    TEST(xstrided_view, transpose)
+    {
+        xarray<double> a = arange<double>(6);
+        a.reshape({2, 3});
+        auto t = transpose(a);
+        EXPECT_EQ(std::vector<size_t>({3, 2}), t.shape());
+        EXPECT_EQ(1, t.strides()[0]);
+        EXPECT_EQ(3, t.strides()[1]);
+        xarray<double> expected = {{0., 3.}, {1., 4.}, {2., 5.}};
+        EXPECT_EQ(expected, xarray<double>(t));
+
+        // The view shares the buffer of the container
+        t(2, 1) = -1.;
+        EXPECT_EQ(-1., a(1, 2));
+        EXPECT_EQ(a, xarray<double>(transpose(t)));
+
+        xtensor<double, 3> b({2, 3, 4});
+        std::iota(b.begin(), b.end(), 0.);
+        auto p = transpose(b, {1, 2, 0});
+        EXPECT_EQ(3u, p.shape()[0]);
+        EXPECT_EQ(2u, p.shape()[2]);
+        for (size_t i = 0; i < 2; ++i)
+        {
+            for (size_t j = 0; j < 3; ++j)
+            {
+                for (size_t k = 0; k < 4; ++k)
+                {
+                    EXPECT_EQ(b(i, j, k), p(j, k, i));
+                }
+            }
+        }
+        xtensor<double, 3> pr = p;
+        EXPECT_EQ(b(1, 2, 3), pr(2, 3, 1));
+
+        EXPECT_THROW(transpose(b, {1, 1, 0}, check_policy::full()), transpose_error);
+        EXPECT_THROW(transpose(b, {1, 0, 2, 3}, check_policy::full()), transpose_error);
+        EXPECT_THROW(transpose(b, {1, 2}, check_policy::full()), transpose_error);
+        EXPECT_THROW(transpose(b, {3, 0, 1}, check_policy::full()), transpose_error);
+        EXPECT_THROW(transpose(b, std::vector<size_t>({1, 2})), transpose_error);
+        EXPECT_THROW(transpose(b + 1., std::vector<size_t>({1, 2, 0, 3})), transpose_error);
+
+        auto s = swapaxes(b, 0, 2);
+        EXPECT_EQ(4u, s.shape()[0]);
+        EXPECT_EQ(b(1, 2, 3), s(3, 2, 1));
+        EXPECT_THROW(swapaxes(b, 0, 3), transpose_error);
+    }
+
+    TEST(xstrided_view, transpose_views_and_functions)
+    {
+        xarray<double> a = arange<double>(24);
+        a.reshape({4, 6});
+
+        // Views on containers are transposed without nesting
+        auto v = view(a, range(1, 3), range(0, 6, 2));
+        auto tv = transpose(v);
+        bool strided = std::is_same<decltype(tv), xstrided_view<xarray<double>&, std::vector<size_t>>>::value;
+        EXPECT_TRUE(strided);
+        EXPECT_EQ(a(2, 4), tv(2, 1));
+
+        // Other expressions are transposed by a generator
+        auto tf = transpose(a + 1.);
+        EXPECT_EQ(a(3, 5) + 1., tf(5, 3));
+        xarray<double> rf = tf;
+        xarray<double> expected = transpose(a) + 1.;
+        EXPECT_EQ(expected, rf);
+        auto sf = swapaxes(a * 2., 1, 0);
+        EXPECT_EQ(a(1, 4) * 2., sf(4, 1));
+    }
+
+    TEST(xstrided_view, transpose_assign)
+    {
+        // Large transpositions are copied by tiles
+        xarray<double> a = arange<double>(130 * 70);
+        a.reshape({130, 70});
+        xarray<double> t = transpose(a);
+        bool ok = true;
+        for (size_t i = 0; i < 130; ++i)
+        {
+            for (size_t j = 0; j < 70; ++j)
+            {
+                ok = ok && t(j, i) == a(i, j);
+            }
+        }
+        EXPECT_TRUE(ok);
+
+        xtensor<double, 3> b({5, 40, 37});
+        std::iota(b.begin(), b.end(), 0.);
+        xtensor<double, 3> r = transpose(b);
+        xtensor<double, 3> s({37, 40, 5});
+        for (size_t i = 0; i < 5; ++i)
+        {
+            for (size_t j = 0; j < 40; ++j)
+            {
+                for (size_t k = 0; k < 37; ++k)
+                {
+                    s(k, j, i) = b(i, j, k);
+                }
+            }
+        }
+        EXPECT_EQ(s, r);
+
+        // Writing a transposed expression into a view
+        xarray<double> c = zeros<double>({70, 130});
+        transpose(c) = a;
+        EXPECT_EQ(t, c);
+    }
+
+    TEST(xstrided_view, reshape_view)
+    {
+        xtensor<double, 3> a({4, 3, 5});
+        std::iota(a.begin(), a.end(), 0.);
+
+        auto r = reshape_view(a, {4, 15});
+        bool strided = std::is_same<decltype(r), xstrided_view<xtensor<double, 3>&, std::array<size_t, 2>>>::value;
+        EXPECT_TRUE(strided);
+        EXPECT_EQ(15, r.strides()[0]);
+        EXPECT_EQ(a(2, 1, 3), r(2, 8));
+        r(3, 14) = -1.;
+        EXPECT_EQ(-1., a(3, 2, 4));
+
+        auto back = reshape_view(r, std::vector<size_t>({4, 3, 5}));
+        EXPECT_EQ(xarray<double>(a), xarray<double>(back));
+        EXPECT_THROW(reshape_view(a, {4, 16}), std::runtime_error);
+
+        // Contiguous views are written through their buffer, views whose
+        // dimensions can be merged are read through it, others are remapped
+        auto v = view(a, range(1, 3));
+        auto rv = reshape_view(v, {6, 5});
+        EXPECT_EQ(a(2, 0, 1), rv(3, 1));
+        rv(5, 4) = -2.;
+        EXPECT_EQ(-2., a(2, 2, 4));
+        auto rrv = reshape_view(view(a, 2, range(1, 3)), {5, 2});
+        rrv(0, 1) = -3.;
+        EXPECT_EQ(-3., a(2, 1, 1));
+        auto s = view(a, all(), 1);
+        auto rs = reshape_view(s, {2, 2, 5});
+        EXPECT_EQ(a(3, 1, 2), rs(1, 1, 2));
+        xarray<double> ers = xarray<double>(s);
+        ers.reshape({2, 2, 5});
+        EXPECT_EQ(ers, xarray<double>(rs));
+
+        auto nc = view(a, all(), range(0, 2));
+        auto rn = reshape_view(nc, {40});
+        EXPECT_EQ(a(0, 0, 0), rn(0));
+        EXPECT_EQ(a(0, 1, 4), rn(9));
+        EXPECT_EQ(a(1, 0, 0), rn(10));
+        EXPECT_EQ(a(3, 1, 4), rn(39));
+        xarray<double> enc = xarray<double>(nc);
+        enc.reshape({40});
+        EXPECT_EQ(enc, xarray<double>(rn));
+
+        // Other expressions are remapped
+        auto rf = reshape_view(a + 1., {60});
+        EXPECT_EQ(a(1, 2, 3) + 1., rf(28));
+        xarray<double, layout::column_major> cm = a;
+        auto rc = reshape_view(cm, {12, 5});
+        EXPECT_EQ(a(2, 1, 3), rc(7, 3));
+        xarray<double> expected = reshape_view(a, {12, 5});
+        EXPECT_EQ(expected, xarray<double>(rc));
+    }
+}
@@ -11,6 +11,7 @@
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xview.hpp"
 #include <algorithm>
+#include <numeric>
 
 namespace xt
 {
@@ -504,5 +505,106 @@ namespace xt
             next_idx(idx2, shape2);
         }
     }
+
+    TEST(xview, strided_data)
+    {
+        xtensor<double, 3> a({4, 3, 5});
+        std::iota(a.begin(), a.end(), 0.);
+
+        auto v1 = view(a, range(1, 3), newaxis(), all(), range(4, 0, -2));
+        std::vector<std::ptrdiff_t> expected_strides = {15, 0, 5, -2};
+        EXPECT_TRUE(std::equal(expected_strides.cbegin(), expected_strides.cend(), v1.strides().cbegin()));
+        EXPECT_EQ(19u, v1.raw_data_offset());
+        EXPECT_EQ(v1(1, 0, 2, 1), v1.raw_data()[v1.raw_data_offset() + 15 + 10 - 2]);
+
+        auto v2 = view(a, newaxis(), 2);
+        EXPECT_EQ(30u, v2.raw_data_offset());
+        EXPECT_EQ(0, v2.strides()[0]);
+        EXPECT_EQ(5, v2.strides()[1]);
+        EXPECT_EQ(1, v2.strides()[2]);
+        EXPECT_EQ(a(2, 1, 3), v2(0, 1, 3));
+    }
+
+    TEST(xview, strided_assign)
+    {
+        using namespace xt::placeholders;
+        xtensor<double, 2> a({6, 8});
+        std::iota(a.begin(), a.end(), 0.);
+
+        // Row blocks are contiguous and broadcast trivially
+        auto rows = view(a, range(2, 4));
+        xtensor<double, 2> b({2, 8});
+        EXPECT_TRUE(rows.is_trivial_broadcast(b.strides()));
+        b = rows;
+        EXPECT_EQ(a(3, 5), b(1, 5));
+        xtensor<double, 2> c = rows + b;
+        EXPECT_EQ(2. * a(2, 7), c(0, 7));
+
+        auto cols = view(a, all(), range(1, 5));
+        EXPECT_FALSE(cols.is_trivial_broadcast(xtensor<double, 2>({6, 4}).strides()));
+        xtensor<double, 2> d = cols;
+        EXPECT_EQ(a(5, 4), d(5, 3));
+
+        xtensor<double, 2> e = view(a, range(5, _, -2), range(7, _, -3));
+        xtensor<double, 2> expected_e = {{47., 44., 41.}, {31., 28., 25.}, {15., 12., 9.}};
+        EXPECT_EQ(expected_e, e);
+
+        // Writes through views
+        xtensor<double, 2> ones({2, 8});
+        std::fill(ones.begin(), ones.end(), 1.);
+        rows = ones;
+        EXPECT_EQ(1., a(2, 0));
+        EXPECT_EQ(1., a(3, 7));
+        EXPECT_EQ(32., a(4, 0));
+
+        view(a, all(), range(0, 8, 4)) = view(a, all(), range(1, 3));
+        EXPECT_EQ(a(4, 1), a(4, 0));
+        EXPECT_EQ(a(4, 2), a(4, 4));
+
+        xarray<double> g = {{-1., -2.}, {-3., -4.}};
+        view(a, range(4, 6), range(6, 8)) += g;
+        EXPECT_EQ(38. - 1., a(4, 6));
+        EXPECT_EQ(47. - 4., a(5, 7));
+
+        xtensor<double, 3> t({2, 3, 4});
+        std::iota(t.begin(), t.end(), 0.);
+        view(t, 1, range(0, 2)) = view(t, 0, range(1, 3), all());
+        EXPECT_EQ(t(0, 2, 3), t(1, 1, 3));
+    }
+
+    TEST(xview, view_of_view)
+    {
+        using namespace xt::placeholders;
+        xtensor<double, 3> a({4, 5, 6});
+        std::iota(a.begin(), a.end(), 0.);
+
+        auto v1 = view(a, range(1, 4), all(), range(_, _, 2));
+        auto v2 = view(v1, 1, range(4, _, -2), newaxis());
+        bool collapsed = std::is_same<decltype(v2), xstrided_view<xtensor<double, 3>&, std::array<size_t, 3>>>::value;
+        EXPECT_TRUE(collapsed);
+        EXPECT_EQ(3u, v2.dimension());
+        EXPECT_EQ(3u, v2.shape()[0]);
+        EXPECT_EQ(1u, v2.shape()[1]);
+        EXPECT_EQ(a(2, 4, 4), v2(0, 0, 2));
+        EXPECT_EQ(a(2, 0, 2), v2(2, 0, 1));
+
+        xtensor<double, 3> expected = view(xtensor<double, 3>(v1), 1, range(4, _, -2), newaxis());
+        xtensor<double, 3> res = v2;
+        EXPECT_EQ(expected, res);
+
+        // Collapsed views write to the container and can be sliced again
+        v2 = xtensor<double, 3>({3, 1, 3}, -1.);
+        EXPECT_EQ(-1., a(2, 2, 0));
+        EXPECT_EQ(31., a(1, 0, 1));
+        auto v3 = view(v2, 2);
+        v3 = xtensor<double, 2>({1, 3}, -2.);
+        EXPECT_EQ(-2., a(2, 0, 2));
+        EXPECT_EQ(-1., a(2, 2, 2));
+
+        const xtensor<double, 3>& ca = a;
+        auto cv = view(view(ca, 3), range(1, 3));
+        EXPECT_EQ(a(3, 2, 5), cv(1, 5));
+        EXPECT_TRUE((std::is_same<decltype(cv)::reference, const double&>::value));
+    }
 }
 